@@ -231,7 +231,7 @@ void CFontz12864::showBetAmount(quint32 creditsBet)
     u8g2_SendBuffer(&_disp);
 }
 
-void CFontz12864::showCardValue(int cardIdx, PlayingCard cardToShow)
+void CFontz12864::drawCardValue(int cardIdx, PlayingCard cardToShow)
 {
     // Clear the requested card position before rendering
     u8g2_SetDrawColor(&_disp, 0);
@@ -360,7 +360,22 @@ void CFontz12864::showCardValue(int cardIdx, PlayingCard cardToShow)
             u8g2_DrawStr(&_disp, 105, 12, cardRank.toUtf8());
         }
     }
+}
 
+void CFontz12864::showCardValue(int cardIdx, PlayingCard cardToShow)
+{
+    drawCardValue(cardIdx, cardToShow);
+    u8g2_SendBuffer(&_disp);
+}
+
+void CFontz12864::showCardValues(QVector<PlayingCard> cards, quint8 cardsToShow)
+{
+    // All the cards in a single push, like clearAllHolds
+    for (int cardIdx = 0; cardIdx < cards.size(); ++cardIdx) {
+        if (cardsToShow & (1 << cardIdx)) {
+            drawCardValue(cardIdx, cards[cardIdx]);
+        }
+    }
     u8g2_SendBuffer(&_disp);
 }
 
@@ -440,6 +455,16 @@ void CFontz12864::clearAllHolds()
     u8g2_SendBuffer(&_disp);
 }
 
+void CFontz12864::showHoldHint(quint8 holdMask)
+{
+    // A short dash under the hold indicator of each card to keep, all written in a single push like clearAllHolds
+    for (int cardIdx = 0; cardIdx < 5; ++cardIdx) {
+        u8g2_SetDrawColor(&_disp, (holdMask & (1 << cardIdx)) ? 1 : 0);
+        u8g2_DrawBox(&_disp, 12 + cardIdx * 24, 29, 7, 1);
+    }
+    u8g2_SendBuffer(&_disp);
+}
+
 void CFontz12864::setupPayTableDisplay(const QString &gameName)
 {
     u8g2_ClearBuffer(&_disp);
@@ -68,10 +68,12 @@ public slots:
     void showWinnings(const QString &winString, quint32 winCredits);
     void showBetAmount(quint32 creditsBet);
     void showCardValue(int cardIdx, PlayingCard cardToShow);
+    void showCardValues(QVector<PlayingCard> cards, quint8 cardsToShow);
     void showHoldIndicator(int cardIdx, bool isHeld);
     void showCardFrames(bool card1, bool card2, bool card3, bool card4, bool card5);
     void displayNoFundsWarning();
     void clearAllHolds();
+    void showHoldHint(quint8 holdMask);
 
     /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
      * Generic Pay Table Interaction Screen                                                                          *
@@ -80,6 +82,9 @@ public slots:
     void displayTablePage(QVector<QPair<const QString, int>> table, int startIdx, int nbItems);
 
 private:
+    // Draws a card to the frame buffer, without sending it (showCardValue and showCardValues push the frame)
+    void drawCardValue(int cardIdx, PlayingCard cardToShow);
+
     u8g2_t _disp;
 
     unsigned char _heart_bitmap[18];
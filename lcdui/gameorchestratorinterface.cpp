@@ -19,6 +19,7 @@
 
 #include "paytableinterface.h"
 
+#include <QCoreApplication>
 #include <QDebug>
 #include <QThread>
 
@@ -35,7 +36,10 @@ GameOrchestratorInterface::GameOrchestratorInterface(int                  nbSoft
       _game       (gameLogic)
 {
     qRegisterMetaType<PlayingCard>("PlayingCard");
+    qRegisterMetaType<QVector<PlayingCard>>("QVector<PlayingCard>");
     _synchroOrc = new GameOrchestrator(_game, 1, *_creds, 0);
+    _synchroOrc->setStrategyDirectory(QCoreApplication::applicationDirPath());
+    _synchroOrc->setSnapshotSignals(true);
 
     // Reset / initialize the holds
     this->resetHolds();
@@ -45,6 +49,7 @@ GameOrchestratorInterface::GameOrchestratorInterface(int                  nbSoft
                              static_cast<void (LCDInterface::*)()>(&GameOrchestratorInterface::displayPayTableForBet));
     this->addSoftkeyFunction("Bet +1", static_cast<void (LCDInterface::*)()>(&GameOrchestratorInterface::betPlus));
     this->addSoftkeyFunction("BetMax", static_cast<void (LCDInterface::*)()>(&GameOrchestratorInterface::betMax));
+    this->addSoftkeyFunction("Assist", static_cast<void (LCDInterface::*)()>(&GameOrchestratorInterface::holdAssist));
     this->addSoftkeyFunction("Return", static_cast<void (LCDInterface::*)()>(&GameOrchestratorInterface::closeGame));
     this->finishSoftkeys();
 
@@ -72,6 +77,28 @@ void GameOrchestratorInterface::showBetAmount()
     emit betAmountUpdated(_synchroOrc->creditsToBet());
 }
 
+void GameOrchestratorInterface::showWinnings(quint8 payoutIdx, quint32 winCredits)
+{
+    emit winningsUpdated(_game->handString(payoutIdx), winCredits);
+}
+
+void GameOrchestratorInterface::showSnapshot(QSharedPointer<const GameSnapshot> snapshot)
+{
+    // Only the primary hand fits on the LCD, its cards and result already shown in this deal (or draw) are left alone
+    const bool   sameStage   = !_shownSnapshot.isNull() && _shownSnapshot->drawn == snapshot->drawn;
+    const quint8 shownCards  = sameStage ? _shownSnapshot->faceUpCards[0] : 0;
+    const quint8 cardsToShow = static_cast<quint8>(snapshot->faceUpCards[0] & ~shownCards);
+    if (cardsToShow != 0) {
+        emit cardsRevealed(snapshot->hands[0].handToVector(), cardsToShow);
+    }
+
+    const bool resultShown = sameStage && !_shownSnapshot->results.isEmpty();
+    if (!snapshot->results.isEmpty() && !resultShown) {
+        showWinnings(snapshot->results[0].payoutIdx, snapshot->results[0].creditsWon);
+    }
+    _shownSnapshot = snapshot;
+}
+
 void GameOrchestratorInterface::betPlus()
 {
     _synchroOrc->cycleBetAmount();
@@ -82,6 +109,38 @@ void GameOrchestratorInterface::betMax()
     _synchroOrc->betMaximum();
 }
 
+void GameOrchestratorInterface::holdAssist()
+{
+    _synchroOrc->holdAssistCycle();
+}
+
+void GameOrchestratorInterface::showHoldAssist(const QString &currentAssist)
+{
+    emit winningsUpdated("Assist: " + currentAssist, 0);
+}
+
+void GameOrchestratorInterface::showOptimalHold(quint8 holdMask, double expectedValue, bool holdApplied)
+{
+    Q_UNUSED(expectedValue);
+
+    if (holdApplied) {
+        // The orchestrator holds the cards itself, only the hold indicators (and the toggle states) must follow
+        const bool holds[Hand::kCardsPerHand] = {(holdMask & 0x01) != 0, (holdMask & 0x02) != 0,
+                                                 (holdMask & 0x04) != 0, (holdMask & 0x08) != 0,
+                                                 (holdMask & 0x10) != 0};
+        _holdCard1 = holds[0];
+        _holdCard2 = holds[1];
+        _holdCard3 = holds[2];
+        _holdCard4 = holds[3];
+        _holdCard5 = holds[4];
+        for (int cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+            emit cardHeld(cardIdx, holds[cardIdx]);
+        }
+    } else {
+        emit holdHintUpdated(holdMask);
+    }
+}
+
 void GameOrchestratorInterface::resetHolds()
 {
     _holdCard1 = false;
@@ -142,6 +201,7 @@ void GameOrchestratorInterface::allowHolds(bool allowed)
         disconnect(_input, &GenericInputHandler::holdPressed, this, &GameOrchestratorInterface::toggleHold);
         disconnect(this, &GameOrchestratorInterface::cardHeld, _synchroOrc, &GameOrchestrator::hold);
         this->resetHolds();
+        emit holdHintUpdated(0);
     }
 }
 
@@ -155,13 +215,17 @@ void GameOrchestratorInterface::displayPayTableForBet()
     disconnect(_synchroOrc, &GameOrchestrator::betUpdated, this, &GameOrchestratorInterface::showBetAmount);
     disconnect(this, &GameOrchestratorInterface::betAmountUpdated, _lcd, &GenericLCD::showBetAmount);
     disconnect(_input, &GenericInputHandler::triggerPressed, _synchroOrc, &GameOrchestrator::dealDraw);
-    disconnect(_synchroOrc, &GameOrchestrator::primaryCardRevealed, _lcd, &GenericLCD::showCardValue);
+    disconnect(_synchroOrc, &GameOrchestrator::gameSnapshot, this, &GameOrchestratorInterface::showSnapshot);
+    disconnect(this, &GameOrchestratorInterface::cardsRevealed, _lcd, &GenericLCD::showCardValues);
     disconnect(this, &GameOrchestratorInterface::cardHeld, _lcd, &GenericLCD::showHoldIndicator);
     disconnect(this, &GameOrchestratorInterface::holdsReset, _lcd, &GenericLCD::clearAllHolds);
     disconnect(_synchroOrc, &GameOrchestrator::readyForHolds, this, &GameOrchestratorInterface::allowHolds);
     disconnect(_synchroOrc, &GameOrchestrator::cardsToRedraw, _lcd, &GenericLCD::showCardFrames);
-    disconnect(_synchroOrc, &GameOrchestrator::primaryHandUpdated, _lcd, &GenericLCD::showWinnings);
+    disconnect(this, &GameOrchestratorInterface::winningsUpdated, _lcd, &GenericLCD::showWinnings);
     disconnect(_synchroOrc, &GameOrchestrator::insufficientFunds, _lcd, &GenericLCD::displayNoFundsWarning);
+    disconnect(_synchroOrc, &GameOrchestrator::holdAssistChanged, this, &GameOrchestratorInterface::showHoldAssist);
+    disconnect(_synchroOrc, &GameOrchestrator::optimalHoldFound, this, &GameOrchestratorInterface::showOptimalHold);
+    disconnect(this, &GameOrchestratorInterface::holdHintUpdated, _lcd, &GenericLCD::showHoldHint);
 
     // Call the paytable display
     PayTableInterface *payTableDisplay = new PayTableInterface(_nbSoftkeys,
@@ -188,13 +252,17 @@ void GameOrchestratorInterface::restoreConnections()
     connect(_synchroOrc, &GameOrchestrator::betUpdated, this, &GameOrchestratorInterface::showBetAmount);
     connect(this, &GameOrchestratorInterface::betAmountUpdated, _lcd, &GenericLCD::showBetAmount);
     connect(_input, &GenericInputHandler::triggerPressed, _synchroOrc, &GameOrchestrator::dealDraw);
-    connect(_synchroOrc, &GameOrchestrator::primaryCardRevealed, _lcd, &GenericLCD::showCardValue);
+    connect(_synchroOrc, &GameOrchestrator::gameSnapshot, this, &GameOrchestratorInterface::showSnapshot);
+    connect(this, &GameOrchestratorInterface::cardsRevealed, _lcd, &GenericLCD::showCardValues);
     connect(this, &GameOrchestratorInterface::cardHeld, _lcd, &GenericLCD::showHoldIndicator);
     connect(this, &GameOrchestratorInterface::holdsReset, _lcd, &GenericLCD::clearAllHolds);
     connect(_synchroOrc, &GameOrchestrator::readyForHolds, this, &GameOrchestratorInterface::allowHolds);
     connect(_synchroOrc, &GameOrchestrator::cardsToRedraw, _lcd, &GenericLCD::showCardFrames);
-    connect(_synchroOrc, &GameOrchestrator::primaryHandUpdated, _lcd, &GenericLCD::showWinnings);
+    connect(this, &GameOrchestratorInterface::winningsUpdated, _lcd, &GenericLCD::showWinnings);
     connect(_synchroOrc, &GameOrchestrator::insufficientFunds, _lcd, &GenericLCD::displayNoFundsWarning);
+    connect(_synchroOrc, &GameOrchestrator::holdAssistChanged, this, &GameOrchestratorInterface::showHoldAssist);
+    connect(_synchroOrc, &GameOrchestrator::optimalHoldFound, this, &GameOrchestratorInterface::showOptimalHold);
+    connect(this, &GameOrchestratorInterface::holdHintUpdated, _lcd, &GenericLCD::showHoldHint);
 
     // Setup and redisplay all items on the interface
     emit displayReset();
@@ -52,6 +52,22 @@ public slots:
      */
     void showBetAmount();
 
+    /**
+     * @brief showWinnings looks up the name of the paytable row hit by the primary hand and forwards it to the LCD
+     *
+     * @param payoutIdx           paytable row of the hand (see PokerGame::handString)
+     * @param winCredits          number of credits won by the hand
+     */
+    void showWinnings(quint8 payoutIdx, quint32 winCredits);
+
+    /**
+     * @brief showSnapshot forwards what changed on the primary hand since the last snapshot of the orchestrator to the
+     *        LCD: the cards turned (in a single write) and the winnings once the hand is scored
+     *
+     * @param snapshot            state of the hands at a render step of the deal or draw
+     */
+    void showSnapshot(QSharedPointer<const GameSnapshot> snapshot);
+
     /**
      * @brief betPlus softkey wrapper for orchestrator's bet cycler
      */
@@ -62,6 +78,27 @@ public slots:
      */
     void betMax();
 
+    /**
+     * @brief holdAssist softkey wrapper for orchestrator's hold assistance cycler
+     */
+    void holdAssist();
+
+    /**
+     * @brief showHoldAssist briefly shows the new hold assistance level where the winnings go
+     *
+     * @param currentAssist       name of the assistance level
+     */
+    void showHoldAssist(const QString &currentAssist);
+
+    /**
+     * @brief showOptimalHold marks the cards of the optimal hold on the LCD, or holds them if the orchestrator did
+     *
+     * @param holdMask            bit i set for the card at index i
+     * @param expectedValue       expected credits won by the hold (not displayed)
+     * @param holdApplied         true if the orchestrator already held the cards
+     */
+    void showOptimalHold(quint8 holdMask, double expectedValue, bool holdApplied);
+
     /**
      * @brief resetHolds unsets the hold status for interfacing with the orchestrator
      */
@@ -97,12 +134,18 @@ signals:
 
     void betAmountUpdated(quint32 totalBetAmount);
 
+    void winningsUpdated(const QString &winString, quint32 winCredits);
+
+    void cardsRevealed(QVector<PlayingCard> cards, quint8 cardsToShow);
+
     void cardHeld(int cardIdx, bool cardIsHeld);
 
     void cardHoldIndic(int cardIdx);
 
     void holdsReset();
 
+    void holdHintUpdated(quint8 holdMask);
+
 private:
     GenericLCD          *_lcd;
     GenericInputHandler *_input;
@@ -115,6 +158,8 @@ private:
     bool                 _holdCard4;
     bool                 _holdCard5;
 
+    QSharedPointer<const GameSnapshot> _shownSnapshot;
+
     QVector<QPair<QString, void (LCDInterface::*)()>> _hiddenKeys;
 };
 
@@ -20,3 +20,17 @@
 GenericLCD::GenericLCD(QObject *parent) : QObject(parent) {}
 
 GenericLCD::~GenericLCD() {}
+
+void GenericLCD::showHoldHint(quint8 holdMask)
+{
+    Q_UNUSED(holdMask);
+}
+
+void GenericLCD::showCardValues(QVector<PlayingCard> cards, quint8 cardsToShow)
+{
+    for (int cardIdx = 0; cardIdx < cards.size(); ++cardIdx) {
+        if (cardsToShow & (1 << cardIdx)) {
+            showCardValue(cardIdx, cards[cardIdx]);
+        }
+    }
+}
@@ -117,6 +117,15 @@ public slots:
      */
     virtual void showCardValue(int cardIdx, PlayingCard cardToShow) = 0;
 
+    /**
+     * @brief showCardValues "flips" several cards of the hand at once (the default flips them one by one, displays
+     *        pushing a whole frame at a time should override this to draw them all in a single push)
+     *
+     * @param[in]  cards          cards of the hand, by position
+     * @param[in]  cardsToShow    bit i set to show the card at position i
+     */
+    virtual void showCardValues(QVector<PlayingCard> cards, quint8 cardsToShow);
+
     /**
      * @brief showHoldIndicator highlights something around the card to show it will be preserved when redrawing
      *
@@ -139,6 +148,14 @@ public slots:
      */
     virtual void clearAllHolds() = 0;
 
+    /**
+     * @brief showHoldHint marks the cards the optimal hold would keep (the default does not show anything, for
+     *        displays without room for one more indicator)
+     *
+     * @param[in]  holdMask       bit i set to mark the card at index i, 0 clears the marks
+     */
+    virtual void showHoldHint(quint8 holdMask);
+
     /* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
      * Generic Pay Table Interaction Screen                                                                          *
      * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
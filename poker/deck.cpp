@@ -19,11 +19,12 @@
 
 #include <exception>
 
-Deck::Deck()
+Deck::Deck() : _nbCards(0), _shuffled(false), _availableCards(0)
 {
 }
 
-Deck::Deck(DeckType typeOfDeck) : _typeOfDeck(typeOfDeck)
+Deck::Deck(DeckType typeOfDeck, QSharedPointer<RandomEngine> randomEngine)
+    : _typeOfDeck(typeOfDeck), _nbCards(0), _shuffled(false), _availableCards(0), _randomEngine(randomEngine)
 {
     /*
      * Populate the deck based on the type requested
@@ -31,112 +32,94 @@ Deck::Deck(DeckType typeOfDeck) : _typeOfDeck(typeOfDeck)
     this->reset();
 
     /*
-     * Initialize a random number generator (RNG), provided by the Qt Framework. The first initialization should be
-     * cryptographically secure (the global() guarantees this), but any calls to shuffle will use a pseudo-random
-     * number generator based on this seed. True video poker machines have far more secure and robust RNGs, but this
-     * is really just for fun.
+     * Without an engine given, draw from a ChaCha20 keystream keyed from the system's entropy source. True video poker
+     * machines have far more secure and robust RNGs, but this is really just for fun.
      */
-    _rand = QRandomGenerator(QRandomGenerator::global()->generate());
+    if (_randomEngine.isNull()) {
+        _randomEngine = RandomEngine::create(RandomEngine::CHACHA20);
+    }
 }
 
-void Deck::shuffle()
+void Deck::setRandomEngine(QSharedPointer<RandomEngine> randomEngine)
 {
-    // For each card in the deck, pick a random location to swap cards using a classic "swap" code
-    for (qint32 cardPosition = 0; cardPosition < _cardDeck.size(); ++cardPosition) {
-        qint32      cardToSwapPosition  = _rand.bounded(_cardDeck.size());
-        PlayingCard cardFromDestination = _cardDeck[cardToSwapPosition];
-        _cardDeck[cardToSwapPosition]   = _cardDeck[cardPosition];
-        _cardDeck[cardPosition]         = cardFromDestination;
+    if (randomEngine.isNull()) {
+        throw std::runtime_error("A deck needs a random engine");
     }
+    _randomEngine = randomEngine;
+}
+
+void Deck::shuffle()
+{
+    // Nothing moves yet, drawCard() runs the Fisher-Yates steps one card at a time
+    _shuffled = true;
 }
 
 PlayingCard Deck::drawCard()
 {
-    if (_cardDeck.empty()) {
+    if (_nbCards == 0) {
         throw std::runtime_error("No available cards in deck");
     }
 
-    // Take a card off the end of the deck
-    PlayingCard cardToGive = _cardDeck.last();
-    _cardDeck.pop_back();
-
-    // Give it back
-    return cardToGive;
+    /*
+     * Fisher-Yates step: swap a random remaining card (possibly the last one itself) with the last card, then take the
+     * last card off the end of the deck and give it back
+     */
+    if (_shuffled) {
+        if (_randomEngine.isNull()) {
+            throw std::runtime_error("A deck needs a random engine");
+        }
+        const quint8      pickedPosition = static_cast<quint8>(_randomEngine->bounded(_nbCards));
+        const PlayingCard pickedCard     = _cardDeck[pickedPosition];
+        _cardDeck[pickedPosition]        = _cardDeck[_nbCards - 1];
+        _cardDeck[_nbCards - 1]          = pickedCard;
+        _cardPositions[_cardDeck[pickedPosition].index()] = pickedPosition;
+    }
+    const PlayingCard drawnCard = _cardDeck[--_nbCards];
+    _availableCards &= ~drawnCard.cardBit();
+    return drawnCard;
 }
 
 void Deck::removeCard(const PlayingCard &cardToRemove)
 {
-    qint32 removeCardPosition = _cardDeck.indexOf(cardToRemove);
-    if (removeCardPosition != -1) {
-        _cardDeck.remove(removeCardPosition);
+    if (!(_availableCards & cardToRemove.cardBit())) {
+        return;
     }
+
+    // Move the last card into the gap
+    const quint8      cardPosition = _cardPositions[cardToRemove.index()];
+    const PlayingCard lastCard     = _cardDeck[--_nbCards];
+    _cardDeck[cardPosition]          = lastCard;
+    _cardPositions[lastCard.index()] = cardPosition;
+    _availableCards                 &= ~cardToRemove.cardBit();
 }
 
 void Deck::addCard(const PlayingCard cardToInsert)
 {
-    _cardDeck.push_back(cardToInsert);
+    if (_nbCards == PlayingCard::kNbCards) {
+        throw std::runtime_error("Adding card will exceed deck limit");
+    } else if (cardToInsert.fakeCard()) {
+        throw std::runtime_error("Cannot add a fake card to the deck");
+    } else if (_availableCards & cardToInsert.cardBit()) {
+        throw std::runtime_error("Card is already in the deck");
+    }
+    _cardPositions[cardToInsert.index()] = _nbCards;
+    _cardDeck[_nbCards++]                = cardToInsert;
+    _availableCards                     |= cardToInsert.cardBit();
 }
 
 void Deck::reset()
 {
+    _shuffled = false;
     if (_typeOfDeck == FULL_FRENCH) {
         // Add all 52 cards of the Full French deck
-        _cardDeck = {
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::TWO),
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::THREE),
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::FOUR),
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::FIVE),
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::SIX),
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::SEVEN),
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::EIGHT),
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::NINE),
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::TEN),
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::JACK),
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::QUEEN),
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::KING),
-            PlayingCard(PlayingCard::CLUB,    PlayingCard::ACE),
-
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::TWO),
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::THREE),
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::FOUR),
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::FIVE),
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::SIX),
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::SEVEN),
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::EIGHT),
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::NINE),
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::TEN),
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::JACK),
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::QUEEN),
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::KING),
-            PlayingCard(PlayingCard::SPADE,   PlayingCard::ACE),
-
-            PlayingCard(PlayingCard::HEART,   PlayingCard::TWO),
-            PlayingCard(PlayingCard::HEART,   PlayingCard::THREE),
-            PlayingCard(PlayingCard::HEART,   PlayingCard::FOUR),
-            PlayingCard(PlayingCard::HEART,   PlayingCard::FIVE),
-            PlayingCard(PlayingCard::HEART,   PlayingCard::SIX),
-            PlayingCard(PlayingCard::HEART,   PlayingCard::SEVEN),
-            PlayingCard(PlayingCard::HEART,   PlayingCard::EIGHT),
-            PlayingCard(PlayingCard::HEART,   PlayingCard::NINE),
-            PlayingCard(PlayingCard::HEART,   PlayingCard::TEN),
-            PlayingCard(PlayingCard::HEART,   PlayingCard::JACK),
-            PlayingCard(PlayingCard::HEART,   PlayingCard::QUEEN),
-            PlayingCard(PlayingCard::HEART,   PlayingCard::KING),
-            PlayingCard(PlayingCard::HEART,   PlayingCard::ACE),
-
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::TWO),
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::THREE),
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::FOUR),
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::FIVE),
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::SIX),
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::SEVEN),
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::EIGHT),
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::NINE),
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::TEN),
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::JACK),
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::QUEEN),
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::KING),
-            PlayingCard(PlayingCard::DIAMOND, PlayingCard::ACE),
-        };
+        const PlayingCard::CardSuit suitOrder[] = {PlayingCard::CLUB, PlayingCard::SPADE,
+                                                   PlayingCard::HEART, PlayingCard::DIAMOND};
+        _nbCards        = 0;
+        _availableCards = 0;
+        for (const PlayingCard::CardSuit suit : suitOrder) {
+            for (quint8 value = PlayingCard::TWO; value <= PlayingCard::ACE; ++value) {
+                addCard(PlayingCard(suit, static_cast<PlayingCard::CardValue>(value)));
+            }
+        }
     }
 }
@@ -19,18 +19,23 @@
 #define DECK_H
 
 #include "playingcard.h"
-
-#include <QRandomGenerator>
-#include <QVector>
+#include "randomengine.h"
 
 /**
  * @brief A Deck is a collection of playing cards from which cards may be dealt one-by-one and shuffled with a RNG.
  *        Cards drawn from the deck are removed from the deck and provided to the caller of drawCard(). Calling the
  *        reset() function will repopulate the deck with DeckType's card allotment. Be sure to shuffle() the deck!
  *
- * @note  The RNG used will be initialized in a cryptographically-secure way, but subsequent calls use the pseudo
- *        RNG after this first initialization. Real hardware-based RNGs are used in actual video poker terminals, but
- *        this is basically just for fun :)
+ * @note  The cards are kept in a fixed-size array of packed PlayingCards, so a deck never allocates. A 64-bit set of
+ *        the available cards and the position of each card in the array make drawing, removing and adding cards O(1).
+ *
+ * @note  Shuffling is a Fisher-Yates shuffle run lazily: shuffle() only arms the deck, and each drawCard() then picks
+ *        one of the remaining cards uniformly at random. A hand only ever draws up to 10 cards, so this takes 10 RNG
+ *        calls instead of 52, and cards added back or removed in between keep the draws uniform.
+ *
+ * @note  The random picks come from a RandomEngine, by default a ChaCha20 CSPRNG keyed from the system's entropy
+ *        source. Real hardware-based RNGs are used in actual video poker terminals, but this is basically just for
+ *        fun :) Simulations can plug a faster engine with setRandomEngine().
  */
 class Deck
 {
@@ -55,50 +60,78 @@ public:
      * @brief      Construct a deck of a given type
      *
      * @param[in]  typeOfDeck      What kind of deck to construct
+     * @param[in]  randomEngine    Engine picking the cards drawn (a new ChaCha20 engine if null)
+     */
+    explicit Deck(DeckType typeOfDeck, QSharedPointer<RandomEngine> randomEngine = QSharedPointer<RandomEngine>());
+
+    /**
+     * @brief      Replaces the engine picking the cards drawn (it may be shared with other decks of the same thread)
+     *
+     * @param[in]  randomEngine    Engine to draw from, must not be null
      */
-    explicit Deck(DeckType typeOfDeck);
+    void setRandomEngine(QSharedPointer<RandomEngine> randomEngine);
 
     /**
-     * @brief      Shuffles the cards using the random number generator initialized at construction time
+     * @brief      Shuffles the cards using the random number generator initialized at construction time. The random
+     *             picks are made as the cards are drawn, until the deck is reset().
      */
     void shuffle();
 
     /**
-     * @brief      DrawCard pulls the last card off the deck and provides it to the caller
+     * @brief      DrawCard pulls a random remaining card off a shuffled deck (the last card of a deck that was not
+     *             shuffled since the last reset) and provides it to the caller
      *
      * @return     A single PlayingCard from the deck
      *
-     * @throws     runtime_error if there are no cards available ("No available cards in deck")
+     * @throws     runtime_error if there are no cards available ("No available cards in deck") or the deck has no
+     *             random engine (only decks built by the default constructor)
      */
     PlayingCard drawCard();
 
     /**
      * @brief      Takes a card out of the deck. This can be handy in multi-hand games where a player would select hold
-     *             cards from one hand and the hold card(s) must be propagated to all other hands in the game
+     *             cards from one hand and the hold card(s) must be propagated to all other hands in the game. The last
+     *             card of the deck fills the gap, which only changes the order of a deck that was not shuffled.
      *
-     * @param[in]  cardToRemove    Card to mark as being unable to get drawn by drawCard
+     * @param[in]  cardToRemove    Card to mark as being unable to get drawn by drawCard (nothing happens if the card
+     *                             is not in the deck)
      */
     void removeCard(const PlayingCard &cardToRemove);
 
     /**
      * @brief      Puts the cardToReplace into the deck. This is also principally intended for multi-hand games.
-     *             Placing a card back into the deck will hurt it's shuffled-ness, so be sure to shuffle after doing
-     *             this operation.
+     *             A shuffled deck stays shuffled, the card being as likely as any other to be drawn next.
      *
      * @param[in]  cardToInsert    Card to put into the deck
+     *
+     * @throws     runtime_error if the deck is already full ("Adding card will exceed deck limit"), the card is already
+     *             in the deck ("Card is already in the deck") or is a fake card ("Cannot add a fake card to the deck")
      */
     void addCard(const PlayingCard cardToInsert);
 
     /**
-     * @brief      Resets the internal black list, restoring the deck back to full eligibility
+     * @brief      Set of the cards left in the deck
+     *
+     * @return     bit PlayingCard::index() of each card that can still be drawn (see PlayingCard::cardBit)
+     */
+    quint64 availableCards() const;
+
+    /**
+     * @brief      Resets the internal black list, restoring the deck back to full eligibility (and unshuffled)
      */
     void reset();
 
 private:
     /* Data members */
-    DeckType             _typeOfDeck;  // What kind of deck is represented?
-    QVector<PlayingCard> _cardDeck;    // Vector of all cards in the deck
-    QRandomGenerator     _rand;        // Random number generator for shuffling and drawing cards
+    DeckType                     _typeOfDeck;                           // What kind of deck is represented?
+    PlayingCard                  _cardDeck[PlayingCard::kNbCards];      // The first _nbCards are left in the deck
+    quint8                       _nbCards;                              // Number of cards left in the deck
+    bool                         _shuffled;                             // Are the cards drawn at random?
+    quint64                      _availableCards;                       // Bit set of the first _nbCards of _cardDeck
+    quint8                       _cardPositions[PlayingCard::kNbCards]; // Position in _cardDeck of each available card
+    QSharedPointer<RandomEngine> _randomEngine;                         // Random engine picking the cards drawn
 };
 
+inline quint64 Deck::availableCards() const {return _availableCards;}
+
 #endif // DECK_H
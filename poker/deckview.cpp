@@ -0,0 +1,60 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "deckview.h"
+
+#include <QtAlgorithms>
+
+#include <exception>
+
+const quint64 DeckView::kFullDeck;
+
+DeckView::DeckView(quint64 availableCards) : _availableCards(availableCards)
+{
+}
+
+PlayingCard DeckView::drawCard(RandomEngine &randomEngine)
+{
+    if (!_availableCards) {
+        throw std::runtime_error("No available cards in deck");
+    }
+
+    // Pick the n-th remaining card: drop the n lowest ones, the card is then the lowest left
+    quint64 cards = _availableCards;
+    for (quint32 skipped = randomEngine.bounded(qPopulationCount(cards)); skipped > 0; --skipped) {
+        cards &= cards - 1;
+    }
+    const quint64 cardBit = cards & (~cards + 1);
+    _availableCards &= ~cardBit;
+    return PlayingCard::fromIndex(static_cast<quint8>(qCountTrailingZeroBits(cardBit)));
+}
+
+void DeckView::removeCard(const PlayingCard &cardToRemove)
+{
+    _availableCards &= ~cardToRemove.cardBit();
+}
+
+void DeckView::addCard(const PlayingCard &cardToInsert)
+{
+    if (cardToInsert.fakeCard()) {
+        throw std::runtime_error("Cannot add a fake card to the deck");
+    } else if (_availableCards & cardToInsert.cardBit()) {
+        throw std::runtime_error("Card is already in the deck");
+    }
+    _availableCards |= cardToInsert.cardBit();
+}
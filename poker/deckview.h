@@ -0,0 +1,81 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DECKVIEW_H
+#define DECKVIEW_H
+
+#include "playingcard.h"
+#include "randomengine.h"
+
+/**
+ * @brief A DeckView is a lightweight deck for the secondary hands of a multi-hand game: the set of cards it can still
+ *        deal, as a single 64-bit card set (see PlayingCard::cardBit). Views are copied by value, so every secondary
+ *        hand draws from its own copy of one shared view (the full deck minus the held cards) instead of owning a Deck.
+ *
+ *        A view owns no random number generator: drawing picks one of the remaining cards uniformly with the engine
+ *        given by the caller, so views are always "shuffled" and cards can be taken out or put back at any time.
+ */
+class DeckView
+{
+public:
+    /// Every card of a full French deck
+    static const quint64 kFullDeck = (Q_UINT64_C(1) << PlayingCard::kNbCards) - 1;
+
+    /**
+     * @brief      Construct a view of a set of cards
+     *
+     * @param[in]  availableCards  cards that can be drawn (the full deck by default)
+     */
+    explicit DeckView(quint64 availableCards = kFullDeck);
+
+    /**
+     * @brief      Draws one of the remaining cards at random
+     *
+     * @param[in]  randomEngine    engine picking the card
+     *
+     * @return     A single PlayingCard from the view
+     *
+     * @throws     runtime_error if there are no cards available ("No available cards in deck")
+     */
+    PlayingCard drawCard(RandomEngine &randomEngine);
+
+    /**
+     * @brief      Takes a card out of the view (nothing happens if the card is not in the view)
+     */
+    void removeCard(const PlayingCard &cardToRemove);
+
+    /**
+     * @brief      Puts a card into the view
+     *
+     * @throws     runtime_error if the card is already in the view ("Card is already in the deck") or is a fake card
+     *             ("Cannot add a fake card to the deck")
+     */
+    void addCard(const PlayingCard &cardToInsert);
+
+    /**
+     * @brief      Set of the cards left in the view
+     */
+    quint64 availableCards() const;
+
+private:
+    quint64 _availableCards;
+};
+
+inline quint64 DeckView::availableCards() const {return _availableCards;}
+
+#endif // DECKVIEW_H
@@ -0,0 +1,198 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "drawoutcomes.h"
+
+#include "handcombinatorics.h"
+
+#include <QDataStream>
+#include <QFile>
+#include <QtAlgorithms>
+
+#include <algorithm>
+
+const quint32 DrawOutcomes::kFileVersion;
+
+namespace {
+
+// "VPDO" (video poker draw outcomes)
+const quint32 kFileMagic   = 0x5650444F;
+
+// Hands are scored by the game in chunks of this many hands while counting
+const int     kScoringChunk = 4096;
+
+const quint8  kNbSubsets    = 1 << Hand::kCardsPerHand;
+
+}  // namespace
+
+DrawOutcomes::DrawOutcomes(PokerGame *game)
+{
+    QVector<QPair<const QString, int>> payTable;
+    game->currentPayTable(1, payTable);
+    for (const QPair<const QString, int> &row : payTable) {
+        _rowNames.push_back(row.first);
+    }
+    const quint32 nbPayRows = static_cast<quint32>(_rowNames.size());
+
+    // Score every 5-card hand once, enumerating them in colex order so the hand number is its colex index
+    _rowByHand.resize(HandCombinatorics::kNbFiveCardHands);
+    QVector<Hand>                  hands(kScoringChunk);
+    QVector<PokerGame::HandResult> results(kScoringChunk);
+    quint32 handIndex = 0;
+    int     nbInChunk = 0;
+    for (quint8 c5 = 4; c5 < PlayingCard::kNbCards; ++c5) {
+        for (quint8 c4 = 3; c4 < c5; ++c4) {
+            for (quint8 c3 = 2; c3 < c4; ++c3) {
+                for (quint8 c2 = 1; c2 < c3; ++c2) {
+                    for (quint8 c1 = 0; c1 < c2; ++c1) {
+                        hands[nbInChunk++] = Hand(PlayingCard::fromIndex(c1), PlayingCard::fromIndex(c2),
+                                                  PlayingCard::fromIndex(c3), PlayingCard::fromIndex(c4),
+                                                  PlayingCard::fromIndex(c5));
+                        const bool lastHand = (handIndex + nbInChunk == HandCombinatorics::kNbFiveCardHands);
+                        if (nbInChunk == kScoringChunk || lastHand) {
+                            game->evaluateHands(hands.constData(), nbInChunk, 1, results.data());
+                            for (int resultIdx = 0; resultIdx < nbInChunk; ++resultIdx) {
+                                _rowByHand[handIndex++] = results[resultIdx].payoutIdx;
+                            }
+                            nbInChunk = 0;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Count every hand in the row it hit for all its (smaller) subsets
+    for (quint8 nbCards = 0; nbCards < Hand::kCardsPerHand; ++nbCards) {
+        _supersetCounts[nbCards].fill(0, HandCombinatorics::binomial(PlayingCard::kNbCards, nbCards) * nbPayRows);
+    }
+    handIndex = 0;
+    for (quint8 c5 = 4; c5 < PlayingCard::kNbCards; ++c5) {
+        for (quint8 c4 = 3; c4 < c5; ++c4) {
+            for (quint8 c3 = 2; c3 < c4; ++c3) {
+                for (quint8 c2 = 1; c2 < c3; ++c2) {
+                    for (quint8 c1 = 0; c1 < c2; ++c1) {
+                        const quint8 row = _rowByHand[handIndex++];
+                        const quint8 cards[Hand::kCardsPerHand] = {c1, c2, c3, c4, c5};
+                        quint32      subsets[kNbSubsets];
+                        HandCombinatorics::subsetIndices(cards, subsets);
+                        for (quint8 subset = 0; subset < kNbSubsets - 1; ++subset) {
+                            const quint8 nbCards = static_cast<quint8>(qPopulationCount(subset));
+                            ++_supersetCounts[nbCards][subsets[subset] * nbPayRows + row];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+DrawOutcomes::DrawOutcomes(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        throw std::runtime_error("Cannot open the draw outcomes file");
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic   = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if (magic != kFileMagic || version != kFileVersion) {
+        throw std::runtime_error("Not a draw outcomes file (or one from another version)");
+    }
+    stream >> _rowNames >> _rowByHand;
+    for (quint8 nbCards = 0; nbCards < Hand::kCardsPerHand; ++nbCards) {
+        stream >> _supersetCounts[nbCards];
+    }
+
+    bool complete = (stream.status() == QDataStream::Ok && !_rowNames.isEmpty() &&
+                     static_cast<quint32>(_rowByHand.size()) == HandCombinatorics::kNbFiveCardHands);
+    for (quint8 nbCards = 0; complete && nbCards < Hand::kCardsPerHand; ++nbCards) {
+        complete = (static_cast<quint32>(_supersetCounts[nbCards].size()) ==
+                    HandCombinatorics::binomial(PlayingCard::kNbCards, nbCards) * _rowNames.size());
+    }
+    for (int handIdx = 0; complete && handIdx < _rowByHand.size(); ++handIdx) {
+        complete = (_rowByHand[handIdx] < _rowNames.size());
+    }
+    if (!complete) {
+        throw std::runtime_error("The draw outcomes file is damaged");
+    }
+}
+
+void DrawOutcomes::save(const QString &fileName) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw std::runtime_error("Cannot write the draw outcomes file");
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << kFileMagic << kFileVersion << _rowNames << _rowByHand;
+    for (quint8 nbCards = 0; nbCards < Hand::kCardsPerHand; ++nbCards) {
+        stream << _supersetCounts[nbCards];
+    }
+    if (stream.status() != QDataStream::Ok) {
+        throw std::runtime_error("Cannot write the draw outcomes file");
+    }
+}
+
+bool DrawOutcomes::matches(const PokerGame &game) const
+{
+    QVector<QPair<const QString, int>> payTable;
+    game.currentPayTable(1, payTable);
+    if (payTable.size() != _rowNames.size()) {
+        return false;
+    }
+    for (int row = 0; row < payTable.size(); ++row) {
+        if (payTable[row].first != _rowNames[row]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DrawOutcomes::countDraws(quint64 dealtCards, QVector<quint32> &drawCounts) const
+{
+    quint8 cards[Hand::kCardsPerHand];
+    HandCombinatorics::sortedCards(dealtCards, cards);
+    quint32 subsets[kNbSubsets];
+    HandCombinatorics::subsetIndices(cards, subsets);
+
+    // Hands containing each subset of the deal, the whole deal being a single hand of its own row
+    const int nbPayRows = _rowNames.size();
+    drawCounts.fill(0, kNbSubsets * nbPayRows);
+    for (quint8 subset = 0; subset < kNbSubsets - 1; ++subset) {
+        const quint32 *counts = supersetCounts(static_cast<quint8>(qPopulationCount(subset)), subsets[subset]);
+        std::copy(counts, counts + nbPayRows, drawCounts.begin() + subset * nbPayRows);
+    }
+    drawCounts[(kNbSubsets - 1) * nbPayRows + _rowByHand[subsets[kNbSubsets - 1]]] = 1;
+
+    // Superset Moebius transform (see HoldSolver): remove the hands containing any dealt card that is not held
+    for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+        const quint8 cardBit = static_cast<quint8>(1 << cardIdx);
+        for (quint8 hold = 0; hold < kNbSubsets; ++hold) {
+            if (!(hold & cardBit)) {
+                for (int row = 0; row < nbPayRows; ++row) {
+                    drawCounts[hold * nbPayRows + row] -= drawCounts[(hold | cardBit) * nbPayRows + row];
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DRAWOUTCOMES_H
+#define DRAWOUTCOMES_H
+
+#include "pokergame.h"
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief DrawOutcomes counts, for every set of 0 to 4 cards, how many of the 5-card hands containing it land in each
+ *        row of a game's paytable. These counts only depend on which row each hand hits, not on what the rows pay.
+ *
+ *        The draws of a hold H of a deal D are the hands F with F & D == H, so by inclusion-exclusion over the held
+ *        sets the number of draws of every hold of a deal ending in every row (countDraws) comes out of 32 lookups per
+ *        row. The value of a hold under any paytable with the same rows is then a dot product of those counts with the
+ *        payouts: a HoldSolver (and a ReturnCalculator) for a new paytable is built from the counts in milliseconds,
+ *        without scoring a single hand.
+ *
+ *        Counting scores every hand once (about a second), the counts can then be saved and loaded back.
+ */
+class DrawOutcomes
+{
+public:
+    /// Version of the file layout written by save(), bumped on any incompatible change
+    static const quint32 kFileVersion = 1;
+
+    /**
+     * @brief      Scores every 5-card hand with the game and counts the hands of each row containing each set of cards
+     *
+     * @param[in]  game           game whose paytable rows are counted (only used during construction)
+     */
+    explicit DrawOutcomes(PokerGame *game);
+
+    /**
+     * @brief      Loads counts saved by save()
+     *
+     * @param[in]  fileName       file written by save()
+     *
+     * @exception  runtime_error will be raised if the file cannot be read or is not a draw outcomes file
+     */
+    explicit DrawOutcomes(const QString &fileName);
+
+    /**
+     * @brief      Writes the counts to a file
+     *
+     * @param[in]  fileName       file to (over)write
+     *
+     * @exception  runtime_error will be raised if the file cannot be written
+     */
+    void save(const QString &fileName) const;
+
+    /**
+     * @brief      Checks the paytable of a game has the rows that were counted (same names, same order), whatever they
+     *             pay
+     */
+    bool matches(const PokerGame &game) const;
+
+    /**
+     * @brief      Number of rows of the paytable counted
+     */
+    int nbRows() const;
+
+    /**
+     * @brief      Paytable row hit by each 5-card hand, indexed by colex index
+     */
+    const QVector<quint8> &rowByHand() const;
+
+    /**
+     * @brief      Number of 5-card hands containing a set of cards, for each paytable row
+     *
+     * @param[in]  nbCards        number of cards in the set (0 to 4)
+     * @param[in]  setIndex       colex index of the set (see HandCombinatorics::colexIndex)
+     *
+     * @return     nbRows() counts
+     */
+    const quint32 *supersetCounts(quint8 nbCards, quint32 setIndex) const;
+
+    /**
+     * @brief      Counts the draws of every hold of a deal that end in each paytable row
+     *
+     * @param[in]  dealtCards     5-card set (see Hand::cardSet())
+     * @param[out] drawCounts     filled with kNbHolds x nbRows() counts, [hold * nbRows() + row] (hold bits in card
+     *                            index order, as in HoldSolver::solve)
+     *
+     * @exception  runtime_error will be raised if the card set does not have exactly 5 cards
+     */
+    void countDraws(quint64 dealtCards, QVector<quint32> &drawCounts) const;
+
+private:
+    QVector<QString> _rowNames;
+    QVector<quint8>  _rowByHand;
+
+    // Hands of each row containing a set of k cards, [k][colex index of the set * nbRows + row] (k < 5)
+    QVector<quint32> _supersetCounts[Hand::kCardsPerHand];
+};
+
+// Trivial accessors are inlined, supersetCounts() is read for every hold of every deal solved
+inline int DrawOutcomes::nbRows() const {return _rowNames.size();}
+
+inline const QVector<quint8> &DrawOutcomes::rowByHand() const {return _rowByHand;}
+
+inline const quint32 *DrawOutcomes::supersetCounts(quint8 nbCards, quint32 setIndex) const
+{
+    return _supersetCounts[nbCards].constData() + setIndex * static_cast<quint32>(_rowNames.size());
+}
+
+#endif // DRAWOUTCOMES_H
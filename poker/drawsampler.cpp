@@ -0,0 +1,175 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "drawsampler.h"
+
+#include "handcombinatorics.h"
+
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Below this many expected successes, binomials are sampled by inversion
+const double kInversionMaxMean = 10.0;
+
+// Uniform double in [0, 1) from 53 random bits
+double uniformDouble(RandomEngine &engine)
+{
+    const quint64 highBits = engine.generate() >> 5;
+    const quint64 lowBits  = engine.generate() >> 6;
+    return static_cast<double>((highBits << 26) | lowBits) / 9007199254740992.0;
+}
+
+// Binomial by inversion of the distribution function, walking up from 0 successes (the mean is below 10, p <= 0.5)
+quint32 binomialInversion(RandomEngine &engine, quint32 nbTrials, double probability)
+{
+    const double  failure  = 1.0 - probability;
+    const double  ratio    = probability / failure;
+    const double  factor   = ratio * (nbTrials + 1);
+    const double  mean     = nbTrials * probability;
+    const quint32 maxCount = static_cast<quint32>(qMin(static_cast<double>(nbTrials),
+                                                       mean + 10.0 * std::sqrt(mean * failure + 1.0)));
+    const double  zeroProb = std::pow(failure, static_cast<double>(nbTrials));
+    for (;;) {
+        quint32 count     = 0;
+        double  countProb = zeroProb;
+        double  uniform   = uniformDouble(engine);
+        while (uniform > countProb && count < maxCount) {
+            uniform -= countProb;
+            ++count;
+            countProb *= factor / count - ratio;
+        }
+        // The (negligible) tail past maxCount is sampled again rather than walked through
+        if (uniform <= countProb) {
+            return count;
+        }
+    }
+}
+
+// Binomial by transformed rejection with squeeze (Hoermann 1993, "BTRS"), for a mean of at least 10 and p <= 0.5
+quint32 binomialRejection(RandomEngine &engine, quint32 nbTrials, double probability)
+{
+    const double trials   = static_cast<double>(nbTrials);
+    const double spread   = std::sqrt(trials * probability * (1.0 - probability));
+    const double b        = 1.15 + 2.53 * spread;
+    const double a        = -0.0873 + 0.0248 * b + 0.01 * probability;
+    const double c        = trials * probability + 0.5;
+    const double vr       = 0.92 - 4.2 / b;
+    const double alpha    = (2.83 + 5.1 / b) * spread;
+    const double logRatio = std::log(probability / (1.0 - probability));
+    const double mode     = std::floor((trials + 1.0) * probability);
+    const double logMode  = std::lgamma(mode + 1.0) + std::lgamma(trials - mode + 1.0);
+    for (;;) {
+        const double u     = uniformDouble(engine) - 0.5;
+        const double v     = uniformDouble(engine);
+        const double us    = 0.5 - std::fabs(u);
+        const double count = std::floor((2.0 * a / us + b) * u + c);
+        if (count < 0.0 || count > trials) {
+            continue;
+        }
+        if (us >= 0.07 && v <= vr) {
+            return static_cast<quint32>(count);
+        }
+        // Accept when v is under the ratio of the probabilities of count and of the mode (in logarithms)
+        const double logV = std::log(v * alpha / (a / (us * us) + b));
+        if (logV <= logMode - std::lgamma(count + 1.0) - std::lgamma(trials - count + 1.0) +
+                    (count - mode) * logRatio) {
+            return static_cast<quint32>(count);
+        }
+    }
+}
+
+}  // namespace
+
+DrawSampler::DrawSampler(PokerGame *game) : _outcomes(game)
+{
+}
+
+DrawSampler::DrawSampler(const DrawOutcomes &outcomes) : _outcomes(outcomes)
+{
+}
+
+QVector<quint32> DrawSampler::rowDistribution(quint64 heldCards) const
+{
+    const quint8 nbHeld = static_cast<quint8>(qPopulationCount(heldCards));
+    if (nbHeld > Hand::kCardsPerHand) {
+        throw std::runtime_error("A hand cannot hold more than 5 cards");
+    }
+
+    // Holding the whole hand leaves a single outcome, the hand itself
+    QVector<quint32> distribution(_outcomes.nbRows(), 0);
+    if (nbHeld == Hand::kCardsPerHand) {
+        distribution[_outcomes.rowByHand()[HandCombinatorics::colexIndex(heldCards)]] = 1;
+    } else {
+        const quint32 *counts = _outcomes.supersetCounts(nbHeld, HandCombinatorics::colexIndex(heldCards));
+        std::copy(counts, counts + _outcomes.nbRows(), distribution.begin());
+    }
+    return distribution;
+}
+
+QVector<quint32> DrawSampler::sampleRows(quint64 heldCards, quint32 nbHands, RandomEngine &engine) const
+{
+    return sampleMultinomial(engine, nbHands, rowDistribution(heldCards));
+}
+
+quint32 DrawSampler::sampleBinomial(RandomEngine &engine, quint32 nbTrials, double probability)
+{
+    if (nbTrials == 0 || probability <= 0.0) {
+        return 0;
+    }
+    if (probability >= 1.0) {
+        return nbTrials;
+    }
+
+    // The samplers expect the less likely of success and failure
+    if (probability > 0.5) {
+        return nbTrials - sampleBinomial(engine, nbTrials, 1.0 - probability);
+    }
+    if (nbTrials * probability < kInversionMaxMean) {
+        return binomialInversion(engine, nbTrials, probability);
+    }
+    return binomialRejection(engine, nbTrials, probability);
+}
+
+QVector<quint32> DrawSampler::sampleMultinomial(RandomEngine &engine, quint32 nbTrials, const QVector<quint32> &weights)
+{
+    quint64 weightLeft = 0;
+    for (quint32 weight : weights) {
+        weightLeft += weight;
+    }
+    if (weightLeft == 0) {
+        throw std::runtime_error("At least one outcome must be possible");
+    }
+
+    // Each outcome takes a binomial share of the trials left, with its probability amongst the outcomes left
+    QVector<quint32> counts(weights.size(), 0);
+    quint32          trialsLeft = nbTrials;
+    for (int outcome = 0; outcome < weights.size() && trialsLeft != 0; ++outcome) {
+        if (weights[outcome] == weightLeft) {
+            counts[outcome] = trialsLeft;
+            break;
+        }
+        counts[outcome] = sampleBinomial(engine, trialsLeft, static_cast<double>(weights[outcome]) / weightLeft);
+        trialsLeft -= counts[outcome];
+        weightLeft -= weights[outcome];
+    }
+    return counts;
+}
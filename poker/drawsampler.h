@@ -0,0 +1,103 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef DRAWSAMPLER_H
+#define DRAWSAMPLER_H
+
+#include "drawoutcomes.h"
+#include "randomengine.h"
+
+#include <QVector>
+
+/**
+ * @brief DrawSampler plays the draw of any number of hands holding the same cards without dealing a single card: it
+ *        only tells how many of the hands end on each row of the paytable.
+ *
+ *        A hand holding the set H and drawing the rest from the deck without H ends on any of the 5-card hands
+ *        containing H with the same probability, so the exact distribution of its rows is the DrawOutcomes count of
+ *        the hands containing H (a single lookup). The rows of N such hands follow the multinomial distribution of
+ *        these counts, which is sampled as a binomial per row (each conditioned on the hands left): the cost of a
+ *        draw depends on the number of rows, not on the number of hands.
+ *
+ *        Building the sampler from a game counts the draw outcomes first (about a second, see DrawOutcomes).
+ */
+class DrawSampler
+{
+public:
+    /**
+     * @brief      Counts the draw outcomes of the game
+     *
+     * @param[in]  game           game whose paytable rows are sampled (only used during construction)
+     */
+    explicit DrawSampler(PokerGame *game);
+
+    /**
+     * @brief      Samples from draw outcomes counted beforehand
+     *
+     * @param[in]  outcomes       draw outcomes of the game (copied)
+     */
+    explicit DrawSampler(const DrawOutcomes &outcomes);
+
+    /**
+     * @brief      Exact distribution of the row of a hand holding a set of cards and drawing the others from the deck
+     *             without them
+     *
+     * @param[in]  heldCards      set of 0 to 5 held cards (see Hand::cardSet())
+     *
+     * @return     number of 5-card hands containing the held cards that end on each paytable row
+     */
+    QVector<quint32> rowDistribution(quint64 heldCards) const;
+
+    /**
+     * @brief      Draws hands holding a set of cards, and counts how many end on each paytable row
+     *
+     * @param[in]  heldCards      set of 0 to 5 held cards (see Hand::cardSet())
+     * @param[in]  nbHands        number of hands drawn
+     * @param[in]  engine         source of randomness of the draw
+     *
+     * @return     number of hands ending on each row, adding up to nbHands
+     */
+    QVector<quint32> sampleRows(quint64 heldCards, quint32 nbHands, RandomEngine &engine) const;
+
+    /**
+     * @brief      Number of successes of independent trials of the same probability (binomial distribution), by
+     *             inversion when fewer than 10 successes are expected and by Hoermann's transformed rejection (BTRS)
+     *             otherwise, so the cost does not grow with the number of trials
+     *
+     * @param[in]  engine         source of randomness
+     * @param[in]  nbTrials       number of trials
+     * @param[in]  probability    probability of success of each trial, in [0, 1]
+     */
+    static quint32 sampleBinomial(RandomEngine &engine, quint32 nbTrials, double probability);
+
+    /**
+     * @brief      Number of independent trials ending on each of a set of outcomes (multinomial distribution)
+     *
+     * @param[in]  engine         source of randomness
+     * @param[in]  nbTrials       number of trials
+     * @param[in]  weights        relative probability of each outcome (e.g. a count of cases), not all 0
+     *
+     * @return     number of trials ending on each outcome, adding up to nbTrials
+     */
+    static QVector<quint32> sampleMultinomial(RandomEngine &engine, quint32 nbTrials, const QVector<quint32> &weights);
+
+private:
+    DrawOutcomes _outcomes;
+};
+
+#endif // DRAWSAMPLER_H
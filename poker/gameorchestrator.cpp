@@ -17,62 +17,232 @@
 
 #include "gameorchestrator.h"
 
+#include "deckview.h"
+#include "randompool.h"
+
+#include <QAtomicInt>
 #include <QDebug>
+#include <QRunnable>
 #include <QThread>
 
+namespace {
+
+/**
+ * @brief Computes the optimal hold of a deal on a pool thread and hands it back to the orchestrator's own thread
+ */
+class OptimalHoldTask : public QRunnable
+{
+public:
+    OptimalHoldTask(GameOrchestrator *orchestrator,
+                    HoldAdvisor      *advisor,
+                    const Hand       &dealtHand,
+                    quint32           nbCreditsBet,
+                    quint32           dealNumber)
+        : _orchestrator(orchestrator),
+          _advisor     (advisor),
+          _dealtHand   (dealtHand),
+          _nbCreditsBet(nbCreditsBet),
+          _dealNumber  (dealNumber) {}
+
+    void run()
+    {
+        try {
+            const HoldAdvisor::Advice advice = _advisor->advise(_dealtHand, _nbCreditsBet);
+            QMetaObject::invokeMethod(_orchestrator, "applyOptimalHold", Qt::QueuedConnection,
+                                      Q_ARG(quint32, _dealNumber), Q_ARG(quint8, advice.holdMask),
+                                      Q_ARG(double, advice.expectedValue));
+        } catch (std::runtime_error &exception) {
+            qDebug() << "WARNING: " << exception.what();
+        }
+    }
+
+private:
+    GameOrchestrator *_orchestrator;
+    HoldAdvisor      *_advisor;
+    Hand              _dealtHand;
+    quint32           _nbCreditsBet;
+    quint32           _dealNumber;
+};
+
+// Secondary hands drawn at a time by a draw thread
+const quint32 kHandsPerDrawChunk = 16;
+
+}  // namespace
+
+/**
+ * @brief Draws the cards of a range of secondary hands in the background, while the player holds
+ */
+class GameOrchestrator::PreDrawTask : public QRunnable
+{
+public:
+    PreDrawTask(GameOrchestrator &orchestrator, quint32 firstHand, quint32 endHand)
+        : _orchestrator(orchestrator), _firstHand(firstHand), _endHand(endHand)
+    {
+    }
+
+    void run()
+    {
+        try {
+            _orchestrator.preDrawSecondaryHands(_firstHand, _endHand);
+        } catch (std::runtime_error &exception) {
+            qDebug() << "WARNING: " << exception.what();
+            _orchestrator._nbPreDrawFailures.fetchAndAddRelaxed(1);
+        }
+    }
+
+private:
+    GameOrchestrator &_orchestrator;
+    quint32           _firstHand;
+    quint32           _endHand;
+};
+
+/**
+ * @brief Draws chunks of secondary hands until none is left (the chunks are claimed one at a time, so a thread done
+ *        early takes over the chunks the others have not reached yet)
+ */
+class GameOrchestrator::SecondaryDrawTask : public QRunnable
+{
+public:
+    SecondaryDrawTask(GameOrchestrator &orchestrator, QAtomicInt &nextChunk, QAtomicInt &nbFailures)
+        : _orchestrator(orchestrator), _nextChunk(nextChunk), _nbFailures(nbFailures)
+    {
+    }
+
+    void run()
+    {
+        const quint32 nbHands = _orchestrator._nbDealtHands;
+        for (;;) {
+            const quint32 firstHand = 1 + static_cast<quint32>(_nextChunk.fetchAndAddRelaxed(1)) * kHandsPerDrawChunk;
+            if (firstHand >= nbHands) {
+                return;
+            }
+            try {
+                _orchestrator.drawSecondaryHands(firstHand, qMin(firstHand + kHandsPerDrawChunk, nbHands));
+            } catch (std::runtime_error &exception) {
+                qDebug() << "WARNING: " << exception.what();
+                _nbFailures.fetchAndAddRelaxed(1);
+            }
+        }
+    }
+
+private:
+    GameOrchestrator &_orchestrator;
+    QAtomicInt       &_nextChunk;
+    QAtomicInt       &_nbFailures;
+};
+
 GameOrchestrator::GameOrchestrator(PokerGame *gameAnalyzer,
                                    quint32    nbHandsToPlay,
                                    Account   &playerAcct,
                                    quint8     renderDelay,
                                    QObject   *parent)
-    : QObject       (parent),
-      _gameAnalyzer (gameAnalyzer),
-      _nbHandsToPlay(nbHandsToPlay),
-      _betsPerHand  (1),
-      _playerAccount(playerAcct),
-      _renderDelayMS(renderDelay),
-      _fakeGame     (false),
-      _handInProg   (false)
+    : QObject        (parent),
+      _gameAnalyzer  (gameAnalyzer),
+      _nbHandsToPlay (nbHandsToPlay),
+      _betsPerHand   (1),
+      _playerAccount (playerAcct),
+      _renderDelayMS (renderDelay),
+      _fakeGame      (false),
+      _handInProg    (false),
+      _snapshotMode  (false),
+      _ultraMode     (false),
+      _nbShownHands  (nbHandsToPlay),
+      _nbDealtHands  (nbHandsToPlay),
+      _revealStage   (NOT_REVEALING),
+      _revealHand    (0),
+      _revealCard    (0),
+      _totalWinnings (0),
+      _paidWinnings  (0),
+      _skipAnimation (false),
+      _revealTimer   (this),
+      _randomEngine  (new RandomPool(RandomEngine::CHACHA20)),
+      _deck          (Deck::FULL_FRENCH, _randomEngine),
+      _heldCards     (0),
+      _hands         (nbHandsToPlay),
+      _sampledDraws  (false),
+      _holdAssist    (NO_ASSIST),
+      _dealNumber    (0),
+      _holdAdvisor   (gameAnalyzer),
+      _seededStreams (false),
+      _gameSeed      (0),
+      _gameNumber    (0),
+      _nextGameNumber(0),
+      _nbDrawThreads (1)
 {
-    // TODO: How many hand should we max out at ---> this is a UI-based problem, the orchestrator should not care
-    _gameCards.reserve(nbHandsToPlay);
-    for (quint32 handCount = 0; handCount < nbHandsToPlay; ++handCount) {
-        Hand pokerHand;
-        Deck cardDeck(Deck::FULL_FRENCH);
-        QPair<Deck, Hand> singleDeckHand(cardDeck, pokerHand);
-        _gameCards.push_back(singleDeckHand);
-    }
+    // Optimal holds are delivered through a queued call, one at a time
+    qRegisterMetaType<quint8>("quint8");
+    qRegisterMetaType<QSharedPointer<const GameSnapshot>>("QSharedPointer<const GameSnapshot>");
+    qRegisterMetaType<QVector<quint32>>("QVector<quint32>");
+    _holdAdvisorPool.setMaxThreadCount(1);
+    _revealTimer.setSingleShot(true);
+    connect(&_revealTimer, &QTimer::timeout, this, &GameOrchestrator::revealNextStep);
+    setDrawThreadCount(QThread::idealThreadCount());
 }
 
 GameOrchestrator::GameOrchestrator(PokerGame *gameAnalyzer,
                                    Hand      &fixedHandTest,
                                    Account   &playerAcct,
                                    QObject   *parent)
-    : QObject       (parent),
-      _gameAnalyzer (gameAnalyzer),
-      _nbHandsToPlay(1),
-      _betsPerHand  (1),
-      _playerAccount(playerAcct),
-      _renderDelayMS(0),
-      _fakeGame     (true),
-      _handInProg   (false)
+    : QObject        (parent),
+      _gameAnalyzer  (gameAnalyzer),
+      _nbHandsToPlay (1),
+      _betsPerHand   (1),
+      _playerAccount (playerAcct),
+      _renderDelayMS (0),
+      _fakeGame      (true),
+      _handInProg    (false),
+      _snapshotMode  (false),
+      _ultraMode     (false),
+      _nbShownHands  (1),
+      _nbDealtHands  (1),
+      _revealStage   (NOT_REVEALING),
+      _revealHand    (0),
+      _revealCard    (0),
+      _totalWinnings (0),
+      _paidWinnings  (0),
+      _skipAnimation (false),
+      _revealTimer   (this),
+      _randomEngine  (RandomEngine::create(RandomEngine::CHACHA20)),
+      _deck          (Deck::FULL_FRENCH, _randomEngine),
+      _heldCards     (0),
+      _hands         (1),
+      _sampledDraws  (false),
+      _holdAssist    (NO_ASSIST),
+      _dealNumber    (0),
+      _holdAdvisor   (gameAnalyzer),
+      _seededStreams (false),
+      _gameSeed      (0),
+      _gameNumber    (0),
+      _nextGameNumber(0),
+      _nbDrawThreads (1)
 {
-    _gameCards.reserve(1);
-    Deck cardDeckToIgnore(Deck::FULL_FRENCH);
-    QPair<Deck, Hand> singleDeckHand(cardDeckToIgnore, fixedHandTest);
-    _gameCards.push_back(singleDeckHand);
+    qRegisterMetaType<quint8>("quint8");
+    qRegisterMetaType<QSharedPointer<const GameSnapshot>>("QSharedPointer<const GameSnapshot>");
+    qRegisterMetaType<QVector<quint32>>("QVector<quint32>");
+    _holdAdvisorPool.setMaxThreadCount(1);
+    _revealTimer.setSingleShot(true);
+    connect(&_revealTimer, &QTimer::timeout, this, &GameOrchestrator::revealNextStep);
+
+    _hands.setHand(0, fixedHandTest);
+    _hands.setHoldMask(0, Hand::kAllHeld);
+}
 
-    for (quint32 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
-        _gameCards[0].second.holdCard(cardIdx, true);
-    }
+GameOrchestrator::~GameOrchestrator()
+{
+    // Computations still queued are pointless now, but a running one uses the advisor until it finishes
+    _holdAdvisorPool.clear();
+    _holdAdvisorPool.waitForDone();
+
+    // Cards may still be drawn in the background for a deal that will never be drawn
+    _drawPool.waitForDone();
 }
 
 Hand GameOrchestrator::retrieveHand(qint32 handNumber) const
 {
-    if (handNumber >= _gameCards.size()) {
+    if (handNumber >= _hands.nbHands()) {
         throw std::runtime_error("Requested hand was out of range");
     }
-    return _gameCards[handNumber].second;
+    return _hands.hand(handNumber);
 }
 
 void GameOrchestrator::setCreditsToBet(qint32 credits)
@@ -96,20 +266,101 @@ bool GameOrchestrator::isGameInProgress() const
     return _handInProg;
 }
 
+void GameOrchestrator::setHoldAssist(HoldAssist assist)
+{
+    _holdAssist = assist;
+}
+
+GameOrchestrator::HoldAssist GameOrchestrator::holdAssist() const
+{
+    return _holdAssist;
+}
+
+void GameOrchestrator::setStrategyDirectory(const QString &directory)
+{
+    _holdAdvisor.useStrategyTables(directory);
+}
+
+void GameOrchestrator::setRandomEngine(QSharedPointer<RandomEngine> randomEngine)
+{
+    // The secondary hands of the current deal may still be drawing from the streams in the background
+    _drawPool.waitForDone();
+    _deck.setRandomEngine(randomEngine);
+    _randomEngine  = randomEngine;
+    _seededStreams = false;
+}
+
+void GameOrchestrator::setGameSeed(quint64 seed, quint64 nextGameNumber)
+{
+    _drawPool.waitForDone();
+    _seededStreams  = true;
+    _gameSeed       = seed;
+    _nextGameNumber = nextGameNumber;
+}
+
+quint64 GameOrchestrator::gameNumber() const
+{
+    return _gameNumber;
+}
+
+quint32 GameOrchestrator::nbRandomUnderruns() const
+{
+    const RandomPool *randomPool = dynamic_cast<const RandomPool *>(_randomEngine.data());
+    return randomPool ? randomPool->nbUnderruns() : 0;
+}
+
+void GameOrchestrator::setDrawThreadCount(int nbThreads)
+{
+    _nbDrawThreads = qMax(1, nbThreads);
+    _drawPool.setMaxThreadCount(qMax(1, _nbDrawThreads - 1));
+}
+
+void GameOrchestrator::setSnapshotSignals(bool enabled)
+{
+    _snapshotMode = enabled;
+}
+
+void GameOrchestrator::setUltraMode(bool enabled)
+{
+    _ultraMode = enabled;
+    if (!_handInProg) {
+        updateHandCounts();
+    }
+}
+
+void GameOrchestrator::setSampledDraws(bool enabled)
+{
+    if (enabled && !_drawSampler) {
+        _drawSampler.reset(new DrawSampler(_gameAnalyzer));
+    }
+    _sampledDraws = enabled;
+    if (!_handInProg) {
+        updateHandCounts();
+    }
+}
+
 void GameOrchestrator::dealDraw()
 {
+    // A deal-draw request while cards are still being revealed only hurries them up
+    if (_revealStage != NOT_REVEALING) {
+        skipAnimation();
+        return;
+    }
+
     if (!_handInProg) {
         /*
          * First stage of the game, no cards dealt so ensure deck is full + shuffled and the target hand(s) empty
-         * The player only interacts with the first hand, so the others will only be initialized and shuffled
+         * The player only interacts with the first hand, the others only draw (from the full deck minus the held
+         * cards) at draw time
          */
+        // Modes changed during the last game only apply from this deal on
+        updateHandCounts();
+
         if (!_fakeGame) {
-            for (QPair<Deck, Hand> &handDeck : _gameCards) {
-                handDeck.first.reset();
-                handDeck.second.reset();
-            }
-            // Only shuffle the deck the player is interacting with. The secondary decks will be shuffled at draw time.
-            _gameCards[0].first.shuffle();
+            _hands.reset();
+            _sampledRows.clear();
+            _deck.reset();
+            _deck.shuffle();
         }
 
         // Must have enough credits to continue
@@ -119,8 +370,15 @@ void GameOrchestrator::dealDraw()
             return;
         }
 
+        // The player's hand (hand 0) deals and draws from its own stream of the game, only numbered once paid for
+        if (_seededStreams && !_fakeGame) {
+            _gameNumber = _nextGameNumber++;
+            _deck.setRandomEngine(QSharedPointer<RandomEngine>(new PhiloxEngine(_gameSeed, _gameNumber, 0)));
+        }
+
         // Set the in progress state right away so the UI will be updated before dealing out cards
         _handInProg = true;
+        ++_dealNumber;
         emit cardsToRedraw(true, true, true, true, true);
         emit gameInProgress(_handInProg);
         emit operating(true);
@@ -132,22 +390,16 @@ void GameOrchestrator::dealDraw()
         if (!_fakeGame) {
             // The initial deal only operates on the main hand
             try {
-                for (quint32 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
-                    // Actual terminals like to give the appearance of a game, so introduce a delay between showing
-                    if (_renderDelayMS != 0)
-                        QThread::msleep(_renderDelayMS);
-
-                    PlayingCard nextCard = _gameCards[0].first.drawCard();
-                    _gameCards[0].second.addCard(nextCard);
-                    emit primaryCardRevealed(cardIdx, nextCard);
-                }
-
-                // For all secondary hands, fill them with null / placeholder cards
-                for (int handIdx = 1; handIdx < _gameCards.size(); ++handIdx) {
+                // For all secondary hands (those dealt card by card), fill them with null / placeholder cards
+                for (int handIdx = 1; handIdx < static_cast<int>(_nbDealtHands); ++handIdx) {
                     for (quint32 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
-                        _gameCards[handIdx].second.addCard(PlayingCard());
+                        _hands.addCard(handIdx, PlayingCard());
                     }
                 }
+
+                for (quint32 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+                    _hands.addCard(0, _deck.drawCard());
+                }
             } catch (std::runtime_error &exception) {
                 qDebug() << "WARNING: " << exception.what();
                 return;
@@ -155,99 +407,329 @@ void GameOrchestrator::dealDraw()
 
             // The nice poker terminals tell you what you have at the first deal (even though you haven't "won" yet)
             // So it is ok to analyze the hand at the deal, so long as we don't "count" the winnings
-            QString handAnalyResult;
-            quint32 handWinCredits;
-            _gameAnalyzer->determineHandAndWin(_gameCards[0].second, _betsPerHand, handAnalyResult, handWinCredits);
-            emit primaryHandUpdated(handAnalyResult, 0);
-            emit operating(false);
-            emit readyForHolds(true);
+            PokerGame::HandResult dealResult = _gameAnalyzer->evaluateHand(_hands.hand(0), _betsPerHand);
+            dealResult.creditsWon = 0;
+            _hands.setResult(0, dealResult);
+
+            // The secondary hands draw their cards in the background meanwhile, so only the holds are left to the draw
+            startPreDraw();
+
+            // The cards are turned over as render steps, the player gets the hand once they are all up
+            startReveal(REVEALING_DEAL, QVector<quint8>(static_cast<int>(_nbShownHands), 0));
         }
     } else {
         /*
          * Second stage of a game, hold cards selected, so draw only non-held-cards, then analyze the win
          */
-        // Do not allow holds
+        // Do not allow holds (nor any optimal hold still being computed for this deal)
+        ++_dealNumber;
         emit readyForHolds(false);
 
-        // Flip the cards back over
-        bool flipCard1 = false;
-        bool flipCard2 = false;
-        bool flipCard3 = false;
-        bool flipCard4 = false;
-        bool flipCard5 = false;
-        if (!_gameCards[0].second.cardHeld(0)) {
-            flipCard1 = true;
+        // Flip the cards back over (every card that is not held)
+        const quint8 holdMask = _hands.holdMask(0);
+        emit cardsToRedraw(!(holdMask & 0x01), !(holdMask & 0x02), !(holdMask & 0x04), !(holdMask & 0x08),
+                           !(holdMask & 0x10));
+        emit operating(true);
+
+        // The secondary hands hold the cards the player held, and skip them amongst the cards they drew
+        _heldCards = 0;
+        for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+            if (holdMask & (1 << cardIdx)) {
+                _heldCards |= _hands.cardAt(0, cardIdx).cardBit();
+            }
         }
-        if (!_gameCards[0].second.cardHeld(1)) {
-            flipCard2 = true;
+
+        // Draw the final hands first (the cards are only revealed below): the player's hand from the deck...
+        try {
+            for (quint32 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+                if (!_hands.cardHeld(0, cardIdx)) {
+                    _hands.replaceCard(0, cardIdx, _deck.drawCard());
+                }
+            }
+        } catch (std::runtime_error &exception) {
+            qDebug() << "WARNING: " << exception.what();
+            return;
+        }
+        _hands.evaluate(_gameAnalyzer, _betsPerHand, 0, 1);
+
+        // ... and the secondary hands by chunks, on as many draw threads as there are chunks, once their cards drawn in
+        // the background are all there (it is usually done long before the player draws). The arrays of the hands were
+        // all written to above (so they are detached already), each thread then only touches the hands of its chunks.
+        if (_nbHandsToPlay > 1) {
+            _drawPool.waitForDone();
+            if (_nbPreDrawFailures.loadAcquire() != 0) {
+                return;
+            }
+
+            if (_nbDealtHands > 1) {
+                QAtomicInt nextChunk(0);
+                QAtomicInt nbFailures(0);
+                const int  nbChunks  = static_cast<int>((_nbDealtHands - 2) / kHandsPerDrawChunk + 1);
+                const int  nbHelpers = qMin(_nbDrawThreads, nbChunks) - 1;
+                for (int helperIdx = 0; helperIdx < nbHelpers; ++helperIdx) {
+                    _drawPool.start(new SecondaryDrawTask(*this, nextChunk, nbFailures));
+                }
+                SecondaryDrawTask(*this, nextChunk, nbFailures).run();
+                _drawPool.waitForDone();
+                if (nbFailures.loadAcquire() != 0) {
+                    return;
+                }
+            }
+
+            // The hands that are not dealt are sampled all at once, from the stream of the first of them
+            if (_nbDealtHands < _nbHandsToPlay) {
+                const quint32  nonce[ChaCha20Engine::kNonceWords] = {_nbDealtHands, 0, 0};
+                ChaCha20Engine drawStream(_streamKey, nonce, 0);
+                PhiloxEngine   handStream(_gameSeed, _gameNumber, _nbDealtHands);
+                RandomEngine  &sampleEngine = _seededStreams ? static_cast<RandomEngine &>(handStream) : drawStream;
+                try {
+                    _sampledRows = _drawSampler->sampleRows(_heldCards, _nbHandsToPlay - _nbDealtHands, sampleEngine);
+                } catch (std::runtime_error &exception) {
+                    qDebug() << "WARNING: " << exception.what();
+                    return;
+                }
+            }
         }
-        if (!_gameCards[0].second.cardHeld(2)) {
-            flipCard3 = true;
+
+        // ... then reveal them (the held cards are up already), the game is over once they are all up
+        QVector<quint8> faceUpCards(static_cast<int>(_nbShownHands));
+        for (quint32 handIdx = 0; handIdx < _nbShownHands; ++handIdx) {
+            faceUpCards[handIdx] = _hands.holdMask(handIdx);
         }
-        if (!_gameCards[0].second.cardHeld(3)) {
-            flipCard4 = true;
+        startReveal(REVEALING_DRAW, faceUpCards);
+    }
+}
+
+void GameOrchestrator::skipAnimation()
+{
+    if (_revealStage == NOT_REVEALING) {
+        return;
+    }
+    _skipAnimation = true;
+    _revealTimer.stop();
+    revealNextStep();
+}
+
+void GameOrchestrator::updateHandCounts()
+{
+    _nbShownHands = _ultraMode ? qMin(_nbHandsToPlay, 1 + kUltraSampleHands) : _nbHandsToPlay;
+    _nbDealtHands = _sampledDraws ? _nbShownHands : _nbHandsToPlay;
+}
+
+void GameOrchestrator::startPreDraw()
+{
+    _nbPreDrawFailures.storeRelease(0);
+    if (!_seededStreams) {
+        for (quint32 &keyWord : _streamKey) {
+            keyWord = _randomEngine->generate();
         }
-        if (!_gameCards[0].second.cardHeld(4)) {
-            flipCard5 = true;
+    }
+    if (_nbDealtHands < 2) {
+        return;
+    }
+
+    // The cards are sized here (so the background threads only write to cards of their own hands), and the hands
+    // split evenly between the threads of the draw pool
+    _preDrawnCards.resize(static_cast<int>(_nbDealtHands * Hand::kCardsPerHand));
+    const quint32 nbSecondaryHands = _nbDealtHands - 1;
+    const quint32 nbChunks         = (nbSecondaryHands - 1) / kHandsPerDrawChunk + 1;
+    const quint32 nbTasks          = qMin(static_cast<quint32>(qMax(1, _nbDrawThreads - 1)), nbChunks);
+    for (quint32 taskIdx = 0; taskIdx < nbTasks; ++taskIdx) {
+        _drawPool.start(new PreDrawTask(*this, 1 + nbSecondaryHands * taskIdx / nbTasks,
+                                        1 + nbSecondaryHands * (taskIdx + 1) / nbTasks));
+    }
+}
+
+void GameOrchestrator::preDrawSecondaryHands(quint32 firstHand, quint32 endHand)
+{
+    PlayingCard *preDrawnCards = _preDrawnCards.data();
+    for (quint32 handIdx = firstHand; handIdx < endHand; ++handIdx) {
+        // Each secondary hand draws from its own copy of the full deck and from its own stream: the hand's stream of
+        // the game if the games are seeded, otherwise a ChaCha20 stream keyed for the game by the orchestrator's engine
+        DeckView       handDeck;
+        const quint32  nonce[ChaCha20Engine::kNonceWords] = {handIdx, 0, 0};
+        ChaCha20Engine drawStream(_streamKey, nonce, 0);
+        PhiloxEngine   handStream(_gameSeed, _gameNumber, handIdx);
+        RandomEngine  &handEngine = _seededStreams ? static_cast<RandomEngine &>(handStream) : drawStream;
+
+        for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+            preDrawnCards[handIdx * Hand::kCardsPerHand + cardIdx] = handDeck.drawCard(handEngine);
         }
-        emit cardsToRedraw(flipCard1, flipCard2, flipCard3, flipCard4, flipCard5);
-        emit operating(true);
+    }
+}
 
-        // ... then reveal them
-        quint32 totalWinnings = 0;
-        for (quint32 handIdx = 0; handIdx < _nbHandsToPlay; ++handIdx) {
-            // Shuffle all secondary decks before drawing!
-            if (handIdx != 0) {
-                _gameCards[handIdx].first.shuffle();
+void GameOrchestrator::drawSecondaryHands(quint32 firstHand, quint32 endHand)
+{
+    const quint8 holdMask = _hands.holdMask(0);
+    for (quint32 handIdx = firstHand; handIdx < endHand; ++handIdx) {
+        // Each secondary hand takes the held cards of the primary hand, and the next cards it drew that were not held
+        // for the others. Those are the first cards of a shuffle of the full deck, so once the held cards are skipped
+        // they are still a uniform draw from the deck without them (and 5 cards always leave enough of them, as at
+        // most the held cards can be skipped).
+        const PlayingCard *preDrawnCard = _preDrawnCards.constData() + handIdx * Hand::kCardsPerHand;
+        for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+            if (holdMask & (1 << cardIdx)) {
+                _hands.replaceCard(handIdx, cardIdx, _hands.cardAt(0, cardIdx));
+            } else {
+                while (_heldCards & preDrawnCard->cardBit()) {
+                    ++preDrawnCard;
+                }
+                _hands.replaceCard(handIdx, cardIdx, *preDrawnCard++);
             }
+        }
+        _hands.setHoldMask(handIdx, holdMask);
+    }
+    _hands.evaluate(_gameAnalyzer, _betsPerHand, static_cast<int>(firstHand), static_cast<int>(endHand));
+}
 
-            try {
-                for (quint32 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
-                    if (!_gameCards[handIdx].second.cardHeld(cardIdx)) {
-                        // Actual terminals like to give the appearance of a game, so introduce a delay between showing
-                        if (_renderDelayMS != 0)
-                            QThread::msleep(_renderDelayMS);
-
-                        PlayingCard nextCard = _gameCards[handIdx].first.drawCard();
-                        _gameCards[handIdx].second.replaceCard(cardIdx, nextCard);
-
-                        if (handIdx == 0) {
-                            // Primary hand cards
-                            emit primaryCardRevealed(cardIdx, nextCard);
-                        } else {
-                            // Secondary hand(s) cards
-                            emit secondaryCardRevealed(handIdx - 1, cardIdx, nextCard, true);
-                        }
+void GameOrchestrator::startReveal(RevealStage stage, const QVector<quint8> &faceUpCards)
+{
+    _revealStage   = stage;
+    _revealHand    = 0;
+    _revealCard    = 0;
+    _faceUpCards   = faceUpCards;
+    _totalWinnings = 0;
+    _paidWinnings  = 0;
+    _skipAnimation = false;
+
+    // Actual terminals like to give the appearance of a game, so every render step waits for the render delay
+    if (_renderDelayMS != 0) {
+        _revealTimer.start(_renderDelayMS);
+    } else {
+        revealNextStep();
+    }
+}
+
+void GameOrchestrator::revealNextStep()
+{
+    if (_revealStage == NOT_REVEALING) {
+        return;
+    }
+
+    const bool    animated = (_renderDelayMS != 0 && !_skipAnimation);
+    const bool    drawn    = (_revealStage == REVEALING_DRAW);
+    const quint32 nbHands  = drawn ? _nbShownHands : 1;
+
+    while (_revealHand < nbHands) {
+        // Turn the next card still face down (in snapshot mode, all those of a secondary hand turn in a single step)
+        const bool wholeHand  = (_snapshotMode && _revealHand != 0);
+        bool       cardTurned = false;
+        while (_revealCard < Hand::kCardsPerHand && (wholeHand || !cardTurned)) {
+            const quint8 cardBit = static_cast<quint8>(1 << _revealCard);
+            if (!(_faceUpCards[_revealHand] & cardBit)) {
+                _faceUpCards[_revealHand] |= cardBit;
+                cardTurned = true;
+                if (!_snapshotMode) {
+                    const PlayingCard card = _hands.cardAt(_revealHand, _revealCard);
+                    if (_revealHand == 0) {
+                        // Primary hand cards
+                        emit primaryCardRevealed(_revealCard, card);
+                    } else {
+                        // Secondary hand(s) cards
+                        emit secondaryCardRevealed(_revealHand - 1, _revealCard, card, true);
                     }
                 }
-            } catch (std::runtime_error &exception) {
-                qDebug() << "WARNING: " << exception.what();
-                return;
             }
+            ++_revealCard;
+        }
 
-            // Analyze the final hand to see what the player has won (if anything), and adjust the balance
-            QString handAnalyRslt;
-            quint32 handWinCreds;
-            _gameAnalyzer->determineHandAndWin(_gameCards[handIdx].second, _betsPerHand, handAnalyRslt, handWinCreds);
-            _playerAccount.add(handWinCreds);
+        // Once all its cards are up, the hand is scored (and what it won is credited if this is the draw)
+        if (_faceUpCards[_revealHand] == Hand::kAllHeld) {
+            const PokerGame::HandResult handResult = _hands.result(_revealHand);
+            _totalWinnings += handResult.creditsWon;
+            if (!_snapshotMode) {
+                if (drawn) {
+                    _playerAccount.add(handResult.creditsWon);
+                }
+                if (_revealHand == 0) {
+                    emit primaryHandUpdated(handResult.payoutIdx, handResult.creditsWon);
+                } else {
+                    emit secondaryHandUpdated(_revealHand - 1, handResult.payoutIdx, handResult.creditsWon);
+                }
+                if (drawn) {
+                    emit gameWinnings(_totalWinnings);
+                }
+            }
+            ++_revealHand;
+            _revealCard = 0;
+        }
 
-            // Update the front-end with the individual hand winnings and total winnings (for multi-handed games)
-            if (handIdx == 0) {
-                // Primary Hand Analysis
-                emit primaryHandUpdated(handAnalyRslt, handWinCreds);
-            } else {
-                // Secondary Hand Analysis
-                emit secondaryHandUpdated(handIdx - 1, handAnalyRslt, handWinCreds);
+        // A turned card ends the render step, the next one waits for a tick (unless it was the last card)
+        if (animated && cardTurned && _revealHand < nbHands) {
+            if (_snapshotMode) {
+                emitSnapshot();
             }
-            totalWinnings += handWinCreds;
-            emit gameWinnings(totalWinnings);
+            _revealTimer.start(_renderDelayMS);
+            return;
         }
+    }
+
+    // In ultra mode, the hands that are not shown are only scored, all at once, and summed up with the others (the
+    // sampled ones being paid by row)
+    if (drawn && _nbShownHands < _nbHandsToPlay) {
+        const int        nbDealtHands   = static_cast<int>(_nbDealtHands);
+        quint32          hiddenWinnings = _hands.totalCredits(static_cast<int>(_nbShownHands), nbDealtHands);
+        QVector<quint32> handsByRow     = _hands.countRows(0, nbDealtHands, _gameAnalyzer->nbPayTableRows());
+        if (!_sampledRows.isEmpty()) {
+            QVector<QPair<const QString, int>> payTable;
+            _gameAnalyzer->currentPayTable(_betsPerHand, payTable);
+            for (int row = 0; row < _sampledRows.size(); ++row) {
+                hiddenWinnings  += _sampledRows[row] * static_cast<quint32>(payTable[row].second);
+                handsByRow[row] += _sampledRows[row];
+            }
+        }
+        _totalWinnings += hiddenWinnings;
+        if (!_snapshotMode) {
+            _playerAccount.add(hiddenWinnings);
+            emit gameWinnings(_totalWinnings);
+        }
+        emit handsSummary(handsByRow, _totalWinnings);
+    }
+
+    if (_snapshotMode) {
+        emitSnapshot();
+    }
+    finishReveal();
+}
+
+void GameOrchestrator::finishReveal()
+{
+    const RevealStage stage = _revealStage;
+    _revealStage = NOT_REVEALING;
+
+    if (stage == REVEALING_DEAL) {
+        emit operating(false);
+        emit readyForHolds(true);
+
+        // The optimal hold is worked out in the background while the player looks at the cards
+        if (_holdAssist != NO_ASSIST) {
+            computeOptimalHold();
+        }
+    } else {
         _handInProg = false;
         emit gameInProgress(_handInProg);
         emit operating(false);
     }
 }
 
+void GameOrchestrator::emitSnapshot()
+{
+    // The winnings of the hands scored in the step are credited at once
+    const bool drawn = (_revealStage == REVEALING_DRAW);
+    if (drawn) {
+        _playerAccount.add(_totalWinnings - _paidWinnings);
+        _paidWinnings = _totalWinnings;
+    }
+
+    GameSnapshot *snapshot  = new GameSnapshot;
+    snapshot->drawn         = drawn;
+    snapshot->hands         = _hands.hands(static_cast<int>(_nbShownHands));
+    snapshot->faceUpCards   = _faceUpCards;
+    snapshot->results       = _hands.results(static_cast<int>(_revealHand));
+    snapshot->totalWinnings = _totalWinnings;
+    emit gameSnapshot(QSharedPointer<const GameSnapshot>(snapshot));
+}
+
 void GameOrchestrator::hold(quint8 cardPosition, bool canHold)
 {
     // Do nothing if a hold was requested for a non-existent card or no hand is currently in progress
@@ -255,35 +737,26 @@ void GameOrchestrator::hold(quint8 cardPosition, bool canHold)
         return;
     }
 
-    // Otherwise set the hold
+    // Nor once the cards are drawn, or for a card of the deal that is not face up yet
+    if (_revealStage == REVEALING_DRAW ||
+        (_revealStage == REVEALING_DEAL && !(_faceUpCards[0] & (1 << cardPosition)))) {
+        return;
+    }
+
+    // Otherwise set the hold on the primary hand only, nothing to do if the card is already in the requested state
+    const quint8 holdBit     = static_cast<quint8>(1 << cardPosition);
+    const quint8 oldHoldMask = _hands.holdMask(0);
+    const quint8 newHoldMask = static_cast<quint8>(canHold ? (oldHoldMask | holdBit) : (oldHoldMask & ~holdBit));
+    if (newHoldMask == oldHoldMask) {
+        return;
+    }
     try {
-        // First the primary hand
-        _gameCards[0].second.holdCard(cardPosition, canHold);
-
-        // See which card was actually held so it can be removed from any secondary decks
-        const PlayingCard heldCard = _gameCards[0].second.cardAt(cardPosition);
-
-        // Then the secondary hands (+ emit to the orchestrator UI that there is a card to show or hide)
-        for (int secondaryIdx = 1; secondaryIdx < _gameCards.size(); ++secondaryIdx) {
-            if (canHold) {
-                // Holding a card will take it out of the deck
-                _gameCards[secondaryIdx].first.removeCard(heldCard);
-                _gameCards[secondaryIdx].second.replaceCard(cardPosition, heldCard);
-                _gameCards[secondaryIdx].second.holdCard(cardPosition, true);
-                emit secondaryCardRevealed(secondaryIdx - 1, cardPosition, heldCard, true);
-            } else {
-                // Un-Holding a card will put it back
-                // WARNING: as a result of this, the deck will lose its randomness, so secondary decks must be shuffled
-                //          before drawing from for the final hand(s) conditions.
-                _gameCards[secondaryIdx].second.replaceCard(cardPosition, PlayingCard());
-                _gameCards[secondaryIdx].first.addCard(heldCard);
-                _gameCards[secondaryIdx].second.holdCard(cardPosition, false);
-                emit secondaryCardRevealed(secondaryIdx - 1, cardPosition, heldCard, false);
-            }
-        }
+        _hands.setHoldMask(0, newHoldMask);
     } catch (std::runtime_error &exception) {
         qDebug() << "WARNING: " << exception.what();
+        return;
     }
+    emit holdMaskChanged(newHoldMask);
 }
 
 void GameOrchestrator::cycleBetAmount()
@@ -332,4 +805,52 @@ void GameOrchestrator::speedControlCycle()
         _renderDelayMS = 150;
         emit renderSpeed(">");
     }
+
+    // Cards being revealed go on at the new speed from the next render step
+    if (_revealTimer.isActive()) {
+        if (_renderDelayMS != 0) {
+            _revealTimer.start(_renderDelayMS);
+        } else {
+            _revealTimer.stop();
+            revealNextStep();
+        }
+    }
+}
+
+void GameOrchestrator::holdAssistCycle()
+{
+    if (_holdAssist == NO_ASSIST) {
+        _holdAssist = SHOW_HINT;
+        emit holdAssistChanged("Hint");
+    } else if (_holdAssist == SHOW_HINT) {
+        _holdAssist = AUTO_HOLD;
+        emit holdAssistChanged("Auto");
+    } else {
+        _holdAssist = NO_ASSIST;
+        emit holdAssistChanged("Off");
+    }
+}
+
+void GameOrchestrator::computeOptimalHold()
+{
+    if (!_handInProg) {
+        return;
+    }
+    _holdAdvisorPool.start(new OptimalHoldTask(this, &_holdAdvisor, _hands.hand(0), _betsPerHand, _dealNumber));
+}
+
+void GameOrchestrator::applyOptimalHold(quint32 dealNumber, quint8 holdMask, double expectedValue)
+{
+    // The cards may have been drawn (or a new deal started) since the computation was requested
+    if (dealNumber != _dealNumber || !_handInProg) {
+        return;
+    }
+
+    const bool applyHold = (_holdAssist == AUTO_HOLD);
+    if (applyHold) {
+        for (quint8 cardPosition = 0; cardPosition < Hand::kCardsPerHand; ++cardPosition) {
+            hold(cardPosition, (holdMask & (1 << cardPosition)) != 0);
+        }
+    }
+    emit optimalHoldFound(holdMask, expectedValue, applyHold);
 }
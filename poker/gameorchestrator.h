@@ -19,17 +19,34 @@
 #define GAMEORCHESTRATOR_H
 
 #include "deck.h"
+#include "drawsampler.h"
+#include "gamesnapshot.h"
+#include "handblock.h"
 #include "hand.h"
 #include "pokergame.h"
 #include "account.h"
+#include "holdadvisor.h"
 
+#include <QAtomicInt>
 #include <QObject>
+#include <QScopedPointer>
+#include <QThreadPool>
+#include <QTimer>
 #include <QVector>
 
 class GameOrchestrator : public QObject
 {
     Q_OBJECT
 public:
+    /**
+     * @brief How much help the player gets from the optimal hold of each deal (see computeOptimalHold)
+     */
+    enum HoldAssist {
+        NO_ASSIST,      // Nothing is computed unless computeOptimalHold is called
+        SHOW_HINT,      // The optimal hold is computed after every deal and emitted for the UI to highlight
+        AUTO_HOLD       // Same as SHOW_HINT, but the optimal hold is also applied to the hand
+    };
+
     /**
      * @brief GameOrchestrator constructor using a generic PokerGame x number of simultaneous hands, and credit account
      *
@@ -65,7 +82,13 @@ public:
                               QObject   *parent = nullptr);
 
     /**
-     * @brief retrieveHand returns the hand at a requested index so it may be inspected for unit testing
+     * @brief ~GameOrchestrator waits for any optimal hold still being computed in the background
+     */
+    ~GameOrchestrator();
+
+    /**
+     * @brief retrieveHand returns the hand at a requested index so it may be inspected for unit testing (the secondary
+     *        hands only get the held cards of the primary hand when the draw starts)
      *
      * @param[in]  handNumber      0-indexed entry in the internal hand vector
      *
@@ -105,15 +128,134 @@ public:
      */
     bool isGameInProgress() const;
 
+    /**
+     * @brief setHoldAssist chooses whether the optimal hold is computed (and applied) after every deal
+     *
+     * @param[in]  assist          assistance level for the following deals
+     */
+    void setHoldAssist(HoldAssist assist);
+
+    /**
+     * @brief holdAssist fetches the current assistance level
+     */
+    HoldAssist holdAssist() const;
+
+    /**
+     * @brief setStrategyDirectory has optimal holds looked up in the precomputed strategy files of a directory (see
+     *        StrategyTable) rather than solved, which matters on boards too slow to build the solver tables
+     *
+     * @param[in]  directory       directory holding the strategy files, empty to always solve
+     */
+    void setStrategyDirectory(const QString &directory);
+
+    /**
+     * @brief setRandomEngine replaces the engine drawing the cards of every hand (a pool of ChaCha20 CSPRNG values
+     *        filled in the background by default), e.g. with a fast reproducible one for simulations. It takes effect
+     *        from the next card drawn, and ends the seeded streams of setGameSeed. The secondary hands draw from
+     *        streams of their own, keyed by the engine at each draw. Waits for the cards of the current deal still
+     *        drawn in the background.
+     *
+     * @param[in]  randomEngine    engine to draw from, must not be null
+     *
+     * @exception  runtime_error will be raised if the engine is null
+     */
+    void setRandomEngine(QSharedPointer<RandomEngine> randomEngine);
+
+    /**
+     * @brief setGameSeed draws the following games from counter-based streams (see PhiloxEngine): hand k of game n
+     *        always draws from the stream of (seed, n, k), whichever thread draws it and in whatever order. Playing
+     *        game n of a seed again with the same holds replays it card for card. Waits for the cards of the current
+     *        deal still drawn in the background.
+     *
+     * @param[in]  seed            seed of the games, to record along with the game numbers
+     * @param[in]  nextGameNumber  number of the next game dealt, the games after it being numbered in sequence
+     */
+    void setGameSeed(quint64 seed, quint64 nextGameNumber = 0);
+
+    /**
+     * @brief gameNumber is the number of the last game dealt from the seed of setGameSeed (meaningless before)
+     */
+    quint64 gameNumber() const;
+
+    /**
+     * @brief nbRandomUnderruns is the number of times the background pool of random values (see RandomPool, the
+     *        default engine of a live game) ran dry and the values had to be generated on the spot (0 for any other
+     *        engine)
+     */
+    quint32 nbRandomUnderruns() const;
+
+    /**
+     * @brief setDrawThreadCount chooses how many threads draw and score the secondary hands of a draw (one per core by
+     *        default). The hands are handed out in chunks, so the threads done early take over the remaining ones.
+     *        Every secondary hand draws from its own stream, so the cards do not depend on the number of threads. The
+     *        cards themselves are drawn on the threads of the pool right after the deal, while the player holds, so
+     *        the draw only places them and scores the hands.
+     *
+     * @param[in]  nbThreads       number of threads, the orchestrator's own thread included (1 draws them all there)
+     */
+    void setDrawThreadCount(int nbThreads);
+
+    /**
+     * @brief setSnapshotSignals switches the cards and results of the deal and draw to a single gameSnapshot signal per
+     *        render step (instead of a signal per card and per hand, which is 600 signals for a 100-hand draw). Without
+     *        a render delay, the deal and the draw are a single step each. With one, every card of the primary hand and
+     *        every secondary hand is a step of its own. The account is credited once per step.
+     *
+     * @param[in]  enabled         true to emit gameSnapshot rather than primaryCardRevealed, secondaryCardRevealed,
+     *                             primaryHandUpdated, secondaryHandUpdated and gameWinnings
+     */
+    void setSnapshotSignals(bool enabled);
+
+    /**
+     * @brief setUltraMode plays games of thousands of hands: only the primary hand and the first kUltraSampleHands
+     *        secondary hands are revealed (and sent in snapshots), the others are scored all at once after them and
+     *        reported through handsSummary. In per-card mode, the winnings of the hands not shown are credited (and
+     *        reported by gameWinnings) in one go.
+     *
+     *        Changing it during a game only applies from the next deal.
+     *
+     * @param[in]  enabled         true to reveal only a sample of the hands
+     */
+    void setUltraMode(bool enabled);
+
+    /// Secondary hands still revealed in ultra mode
+    static const quint32 kUltraSampleHands = 9;
+
+    /**
+     * @brief setSampledDraws skips the cards of the hands that are not shown in ultra mode: the number of them ending
+     *        on each paytable row is sampled from the exact distribution of the hold instead (see DrawSampler), so a
+     *        draw costs the same for 1,000 or 10,000 hands. The hands keep the same odds, but have no cards (nor
+     *        results of their own), only handsSummary and the winnings account for them. Has no effect outside of ultra
+     *        mode.
+     *
+     *        Enabling it counts the draw outcomes of the game the first time (about a second). Changing it during a
+     *        game only applies from the next deal.
+     *
+     * @param[in]  enabled         true to sample the rows of the hands not shown rather than dealing them
+     */
+    void setSampledDraws(bool enabled);
+
 public slots:
     /**
      * @brief dealDraw will deal 5 cards per _gameCard pair when called the first time. When called the second time, it
      *        will only replace the cards that were not held with new cards.
+     *
+     * @note  the cards are revealed one render step per tick of the render delay, without blocking the orchestrator's
+     *        thread. Calling dealDraw while they are still being revealed only skips the animation (see
+     *        skipAnimation). Without a render delay, everything is revealed before dealDraw returns.
      */
     void dealDraw();
 
     /**
-     * @brief hold ensures a card will not be replaced with a new card from the following call to dealDraw
+     * @brief skipAnimation reveals right away the cards of the deal or draw still waiting for their render step (the
+     *        next deal or draw is animated again)
+     */
+    void skipAnimation();
+
+    /**
+     * @brief hold ensures a card will not be replaced with a new card from the following call to dealDraw. Only the
+     *        primary hand's hold mask changes (see holdMaskChanged), the secondary hands get the held cards in one
+     *        batch when the draw starts, so a hold costs the same whatever the number of hands.
      *
      * @param[in]  cardPosition    position in the deck to set the hold status
      * @param[in]  canHold         true if the card should not be replaced with a call to dealDraw
@@ -134,7 +276,8 @@ public slots:
     void betMaximum();
 
     /**
-     * @brief speedControl will adjust the delay between card draws:
+     * @brief speedControl will adjust the delay between card draws (taking effect from the next render step, even in
+     *        the middle of a deal or draw):
      *
      *            +--> Instant --> Slow 150ms --> Medium 100ms --> Fast 50ms ---+
      *            |                                                             |
@@ -142,6 +285,25 @@ public slots:
      */
     void speedControlCycle();
 
+    /**
+     * @brief holdAssistCycle steps through the hold assistance levels:
+     *
+     *            +--> Off --> Hint --> Auto ---+
+     *            |                             |
+     *            +-----------------------------+
+     */
+    void holdAssistCycle();
+
+    /**
+     * @brief computeOptimalHold starts computing the hold with the highest expected value for the primary hand in the
+     *        background. Nothing happens if no hand is waiting for holds. The result is emitted with optimalHoldFound
+     *        unless the cards are drawn first. Deals that are suit renamings of an earlier one are answered at once.
+     *
+     * @note  the first call for a bet builds the tables of the game for that bet, which keeps one core busy for about a
+     *        second on a desktop (much longer on small boards). It never delays dealDraw.
+     */
+    void computeOptimalHold();
+
 signals:
     /**
      * @brief betUpdated is emitted when the user requested a bet amount change and a new paytable should be shown
@@ -171,8 +333,10 @@ signals:
 
     /**
      * @brief primaryHandUpdated indicates the result of the hand analysis and any winnings associated with that hand
+     *
+     * @note  the hand is given as a paytable row, use PokerGame::handString() to get its display name
      */
-    void primaryHandUpdated(const QString &handString, quint32 winning);
+    void primaryHandUpdated(quint8 payoutIdx, quint32 winning);
 
     /**
      * @brief gameWinnings indicates how much has been won on the game so far (running total of all hands played)
@@ -184,15 +348,38 @@ signals:
      */
     void primaryCardRevealed(int cardIdx, PlayingCard card);
 
+    /**
+     * @brief handsSummary indicates the results of all the hands of a draw in ultra mode (see setUltraMode), once they
+     *        are all scored
+     *
+     * @param[in]  handsByRow      number of hands (the primary one included) ending on each row of the paytable
+     * @param[in]  totalWinnings   credits won by all the hands
+     */
+    void handsSummary(QVector<quint32> handsByRow, quint32 totalWinnings);
+
+    /**
+     * @brief holdMaskChanged indicates the cards held on the primary hand changed, the secondary hands will hold the
+     *        same cards when they are drawn
+     *
+     * @param[in]  holdMask        bit i is set if the card at position i is held (the layout of Hand::holdMask())
+     */
+    void holdMaskChanged(quint8 holdMask);
+
     /**
      * @brief secondaryCardRevealed indicates card at cardIdx on a secondary hand handIdx is displayable (show == true)
      */
     void secondaryCardRevealed(int handIdx, int cardIdx, PlayingCard card, bool show);
 
     /**
-     * @brief secondaryHandUpdated
+     * @brief secondaryHandUpdated is the primaryHandUpdated equivalent for the secondary hand at handIdx
+     */
+    void secondaryHandUpdated(int handIdx, quint8 payoutIdx, quint32 winning);
+
+    /**
+     * @brief gameSnapshot gives the state of every hand at a render step of the deal or draw (snapshot mode only, see
+     *        setSnapshotSignals)
      */
-    void secondaryHandUpdated(int handIdx, const QString &handString, quint32 winning);
+    void gameSnapshot(QSharedPointer<const GameSnapshot> snapshot);
 
     /**
      * @brief renderSpeed indicates the card draw speed was changed
@@ -204,7 +391,89 @@ signals:
      */
     void insufficientFunds();
 
+    /**
+     * @brief optimalHoldFound gives the best hold of the primary hand (bit i set to hold the card at index i) and its
+     *        expected value in credits. holdApplied is true if the orchestrator already held those cards (AUTO_HOLD).
+     */
+    void optimalHoldFound(quint8 holdMask, double expectedValue, bool holdApplied);
+
+    /**
+     * @brief holdAssistChanged indicates the hold assistance level was changed by holdAssistCycle
+     */
+    void holdAssistChanged(const QString &currentAssist);
+
+private slots:
+    // Receives the optimal hold computed in the background for the deal numbered dealNumber
+    void applyOptimalHold(quint32 dealNumber, quint8 holdMask, double expectedValue);
+
+    // Reveals the cards of the next render step of the deal or draw, on each tick of the reveal timer
+    void revealNextStep();
+
 private:
+    class PreDrawTask;
+    class SecondaryDrawTask;
+
+    /**
+     * @brief What the cards being revealed belong to
+     */
+    enum RevealStage {
+        NOT_REVEALING,
+        REVEALING_DEAL,     // The primary hand of the deal
+        REVEALING_DRAW      // Every hand of the draw
+    };
+
+    /**
+     * @brief updateHandCounts sets the number of hands shown and dealt from the ultra mode and sampled draws settings,
+     *        which only change between games (the current game keeps its own)
+     */
+    void updateHandCounts();
+
+    /**
+     * @brief startPreDraw keys the streams of the secondary hands for the game, and has the draw pool draw their cards
+     *        in the background (see preDrawSecondaryHands) while the deal is revealed and the player holds
+     */
+    void startPreDraw();
+
+    /**
+     * @brief preDrawSecondaryHands draws the first 5 cards of a shuffle of the full deck for each hand of a range of
+     *        secondary hands, from the hand's own stream (the cards it draws from once the player has held)
+     *
+     * @param[in]  firstHand       first hand of the range
+     * @param[in]  endHand         hand following the last one of the range
+     *
+     * @exception  runtime_error will be raised if a hand cannot draw its cards
+     */
+    void preDrawSecondaryHands(quint32 firstHand, quint32 endHand);
+
+    /**
+     * @brief drawSecondaryHands fills the cards that are not held in a range of secondary hands with the cards they
+     *        drew beforehand (the held cards being skipped) and scores them
+     *
+     * @param[in]  firstHand       first hand of the range
+     * @param[in]  endHand         hand following the last one of the range
+     */
+    void drawSecondaryHands(quint32 firstHand, quint32 endHand);
+
+    /**
+     * @brief startReveal starts revealing the cards of the deal or of the draw (in _hands) as render steps,
+     *        the cards already face up being left as they are
+     *
+     * @param[in]  stage           REVEALING_DEAL or REVEALING_DRAW
+     * @param[in]  faceUpCards     cards already shown on each hand
+     */
+    void startReveal(RevealStage stage, const QVector<quint8> &faceUpCards);
+
+    /**
+     * @brief finishReveal ends the deal (ready for holds) or the game (once the draw is revealed)
+     */
+    void finishReveal();
+
+    /**
+     * @brief emitSnapshot emits the state of the hands being revealed (see gameSnapshot), crediting the winnings of the
+     *        hands scored since the last one
+     */
+    void emitSnapshot();
+
     PokerGame                  *_gameAnalyzer;
     quint32                     _nbHandsToPlay;
     quint32                     _betsPerHand;
@@ -212,7 +481,56 @@ private:
     quint8                      _renderDelayMS;
     bool                        _fakeGame;
     bool                        _handInProg;
-    QVector<QPair<Deck, Hand>>  _gameCards;
+    bool                        _snapshotMode;
+    bool                        _ultraMode;
+    quint32                     _nbShownHands;      // Hands revealed (all of them unless in ultra mode)
+    quint32                     _nbDealtHands;      // Hands drawn card by card (all of them unless draws are sampled)
+
+    // Cards being revealed: the next one to look at, what is shown so far and the winnings of the hands scored
+    RevealStage                 _revealStage;
+    quint32                     _revealHand;
+    quint32                     _revealCard;
+    QVector<quint8>             _faceUpCards;
+    quint32                     _totalWinnings;
+    quint32                     _paidWinnings;
+    bool                        _skipAnimation;
+    QTimer                      _revealTimer;
+
+    // Cards of the game: the player's deck, and the cards the secondary hands draw in the background after the deal
+    // (5 per hand, each hand drawing from its own stream, keyed by the engine unless the games are seeded) and fill
+    // their hands with when the draw starts, skipping the cards held
+    QSharedPointer<RandomEngine>    _randomEngine;
+    Deck                            _deck;
+    quint32                         _streamKey[ChaCha20Engine::kKeyWords];
+    QVector<PlayingCard>            _preDrawnCards;
+    QAtomicInt                      _nbPreDrawFailures;
+    quint64                         _heldCards;
+
+    // Every hand of the game and its result, as contiguous arrays (so the whole draw is drawn and scored in place)
+    HandBlock                       _hands;
+
+    // Sampled draws: the sampler (once enabled), and how many of the hands not dealt ended on each row of the paytable
+    QScopedPointer<DrawSampler>     _drawSampler;
+    bool                            _sampledDraws;
+    QVector<quint32>                _sampledRows;
+
+    // Optimal hold computation: results of an earlier deal (or of a deal already drawn) are dropped
+    HoldAssist                      _holdAssist;
+    quint32                         _dealNumber;
+
+    // Hold advisor: computes the optimal holds of the hint, one deal at a time on a thread of its own
+    HoldAdvisor                     _holdAdvisor;
+    QThreadPool                     _holdAdvisorPool;
+
+    // Counter-based streams of setGameSeed: the seed and the number of the current game
+    bool                            _seededStreams;
+    quint64                         _gameSeed;
+    quint64                         _gameNumber;
+    quint64                         _nextGameNumber;
+
+    // Threads drawing the secondary hands: the orchestrator's own thread, helped by the threads of the pool
+    int                             _nbDrawThreads;
+    QThreadPool                     _drawPool;
 };
 
 #endif // GAMEORCHESTRATOR_H
@@ -0,0 +1,47 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef GAMESNAPSHOT_H
+#define GAMESNAPSHOT_H
+
+#include "hand.h"
+#include "pokergame.h"
+
+#include <QMetaType>
+#include <QSharedPointer>
+#include <QVector>
+
+/**
+ * @brief GameSnapshot is the state of every hand of a game at one render step, as emitted by the GameOrchestrator in
+ *        its snapshot mode (see GameOrchestrator::setSnapshotSignals) instead of one signal per card and per hand.
+ *
+ *        Snapshots are complete (a UI may apply any of them on its own) and immutable once emitted: they are shared
+ *        between threads as QSharedPointer<const GameSnapshot> without any copy.
+ */
+struct GameSnapshot
+{
+    bool                           drawn;            // false for the snapshots of the deal, true for those of the draw
+    QVector<Hand>                  hands;            // Cards of every hand, hand 0 being the player's
+    QVector<quint8>                faceUpCards;      // For each hand, bit i set if the card at position i is shown
+    QVector<PokerGame::HandResult> results;          // Results of the hands scored so far, from hand 0 on
+    quint32                        totalWinnings;    // Credits won by the hands scored so far
+};
+
+Q_DECLARE_METATYPE(QSharedPointer<const GameSnapshot>)
+
+#endif // GAMESNAPSHOT_H
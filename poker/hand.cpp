@@ -19,20 +19,17 @@
 
 #include <exception>
 
-// All poker hands (at least so far...) are presumed to have 5 cards.
-// This parameter is to avoid using "magic numbers" in the code (instead referring to kCardsPerHand)
-const quint8 Hand::kCardsPerHand = 5;
+// Out-of-line definitions for the in-class constants (needed whenever they are bound to a reference)
+const quint8 Hand::kCardsPerHand;
+const quint8 Hand::kAllHeld;
 
-Hand::Hand()
+Hand::Hand() : _nbCards(0), _holdMask(0), _cardSet(0)
 {
-    // Claim 5 spaces for cards, to be used later
-    _handCardStatus.reserve(kCardsPerHand);
 }
 
 Hand::Hand(PlayingCard card1, PlayingCard card2, PlayingCard card3, PlayingCard card4, PlayingCard card5)
+    : _nbCards(0), _holdMask(0), _cardSet(0)
 {
-    // Claim 5 spaces for cards
-    _handCardStatus.reserve(kCardsPerHand);
     addCard(card1);
     addCard(card2);
     addCard(card3);
@@ -42,51 +39,69 @@ Hand::Hand(PlayingCard card1, PlayingCard card2, PlayingCard card3, PlayingCard
 
 void Hand::addCard(PlayingCard card)
 {
-    if (_handCardStatus.size() == kCardsPerHand) {
+    if (_nbCards == kCardsPerHand) {
         throw std::runtime_error("Adding card will exceed hand limit");
     }
-    _handCardStatus.push_back({card, false});
+    _cards[_nbCards++] = card;
+    _cardSet |= card.cardBit();
 }
 
 const PlayingCard Hand::cardAt(quint8 cardIdx) const
 {
-    return _handCardStatus[cardIdx].first;
+    return _cards[cardIdx];
 }
 
 void Hand::holdCard(quint8 cardNum, bool hold)
 {
-    if (_handCardStatus.size() != kCardsPerHand) {
+    if (_nbCards != kCardsPerHand) {
         throw std::runtime_error("Hand is not fully filled");
     }
-    _handCardStatus[cardNum].second = hold;
+    if (hold) {
+        _holdMask |= (1 << cardNum);
+    } else {
+        _holdMask &= ~(1 << cardNum);
+    }
 }
 
 bool Hand::cardHeld(quint8 cardNum) const
 {
-    if (cardNum >= _handCardStatus.size()) {
+    if (cardNum >= _nbCards) {
         throw std::runtime_error("Request to hold card not in hand");
     }
-    return _handCardStatus[cardNum].second;
+    return (_holdMask >> cardNum) & 1;
 }
 
 void Hand::replaceCard(quint8 cardNum, PlayingCard card)
 {
-    if (cardNum >= _handCardStatus.size()) {
+    if (cardNum >= _nbCards) {
         throw std::runtime_error("Attempt to replace a card not in the hand");
     }
-    _handCardStatus[cardNum].first = card;
+    _cardSet &= ~_cards[cardNum].cardBit();
+    _cardSet |= card.cardBit();
+    _cards[cardNum] = card;
 }
 
 void Hand::reset()
 {
-    _handCardStatus.clear();
+    _nbCards  = 0;
+    _holdMask = 0;
+    _cardSet  = 0;
 }
 
 QVector<PlayingCard> Hand::handToVector() const
 {
     QVector<PlayingCard> cards;
-    for (const QPair<PlayingCard, bool> &singleCard : _handCardStatus) {
-        cards.push_back(singleCard.first);
+    cards.reserve(_nbCards);
+    for (quint8 cardIdx = 0; cardIdx < _nbCards; ++cardIdx) {
+        cards.push_back(_cards[cardIdx]);
     }
     return cards;
 }
+
+void Hand::setHoldMask(quint8 holdMask)
+{
+    if (_nbCards != kCardsPerHand) {
+        throw std::runtime_error("Hand is not fully filled");
+    }
+    _holdMask = holdMask & kAllHeld;
+}
@@ -24,12 +24,20 @@
 
 /**
  * @brief A Hand is a set of 5 cards making up a poker hand. Cards may be inserted into a hand, held, and redrawn
+ *
+ * @note  Hands are fixed-size values (16 bytes): the 5 packed cards, a 5-bit hold mask and a 64-bit card set with one
+ *        bit per card index (see PlayingCard::index). Copying them around or keeping hundreds of them costs no heap
+ *        allocations, and the card set can be handed straight to the HandEvaluator.
  */
 class Hand
 {
 public:
-    /// Number of cards comprising a complete hand
-    const static quint8 kCardsPerHand;
+    /// Number of cards comprising a complete hand. All poker hands (at least so far...) are presumed to have 5 cards.
+    /// This parameter is to avoid using "magic numbers" in the code (instead referring to kCardsPerHand)
+    static const quint8 kCardsPerHand = 5;
+
+    /// Hold mask with every card of a complete hand held
+    static const quint8 kAllHeld = (1 << kCardsPerHand) - 1;
 
     /**
      * @brief      For some reason, old version of Qt containers do not like the explicit constructor and need to have
@@ -113,9 +121,47 @@ public:
      */
     QVector<PlayingCard> handToVector() const;
 
+    /**
+     * @brief      Number of cards added to the hand so far
+     *
+     * @return     0 for an empty hand up to kCardsPerHand for a complete one
+     */
+    quint8 nbCards() const;
+
+    /**
+     * @brief      Hold status of all cards at once
+     *
+     * @return     bit N is set if the card at index N is held
+     */
+    quint8 holdMask() const;
+
+    /**
+     * @brief      Sets the hold status of all cards at once
+     *
+     * @param[in]  holdMask   bit N set to hold the card at index N (bits above kCardsPerHand are ignored)
+     *
+     * @throws     runtime_error if the hand does not have all 5 cards ("Hand is not fully filled")
+     */
+    void setHoldMask(quint8 holdMask);
+
+    /**
+     * @brief      All (non-placeholder) cards of the hand as a set
+     *
+     * @return     bit N is set if the card with PlayingCard::index() N is in the hand
+     */
+    quint64 cardSet() const;
+
 private:
-    // Each card in the hand.
-    QVector<QPair<PlayingCard, bool>> _handCardStatus;
+    PlayingCard _cards[kCardsPerHand];  // Each card in the hand
+    quint8      _nbCards;               // How many of _cards were added
+    quint8      _holdMask;              // Bit N set if _cards[N] is held
+    quint64     _cardSet;               // Union of the cardBit() of all cards in the hand
 };
 
+inline quint8 Hand::nbCards() const {return _nbCards;}
+
+inline quint8 Hand::holdMask() const {return _holdMask;}
+
+inline quint64 Hand::cardSet() const {return _cardSet;}
+
 #endif // HAND_H
@@ -0,0 +1,148 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "handblock.h"
+
+HandBlock::HandBlock(int nbHands)
+    : _cards     (nbHands * Hand::kCardsPerHand),
+      _nbCards   (nbHands, 0),
+      _holdMasks (nbHands, 0),
+      _cardSets  (nbHands, 0),
+      _payoutIdx (nbHands, 0),
+      _creditsWon(nbHands, 0)
+{
+}
+
+void HandBlock::reset()
+{
+    _cards.fill(PlayingCard());
+    _nbCards.fill(0);
+    _holdMasks.fill(0);
+    _cardSets.fill(0);
+    _payoutIdx.fill(0);
+    _creditsWon.fill(0);
+}
+
+void HandBlock::addCard(int handIdx, PlayingCard card)
+{
+    if (_nbCards[handIdx] == Hand::kCardsPerHand) {
+        throw std::runtime_error("Adding card will exceed hand limit");
+    }
+    _cards[handIdx * Hand::kCardsPerHand + _nbCards[handIdx]++] = card;
+    _cardSets[handIdx] |= card.cardBit();
+}
+
+void HandBlock::replaceCard(int handIdx, quint8 cardIdx, PlayingCard card)
+{
+    if (cardIdx >= _nbCards[handIdx]) {
+        throw std::runtime_error("Attempt to replace a card not in the hand");
+    }
+    PlayingCard &handCard = _cards[handIdx * Hand::kCardsPerHand + cardIdx];
+    _cardSets[handIdx] = (_cardSets[handIdx] & ~handCard.cardBit()) | card.cardBit();
+    handCard = card;
+}
+
+void HandBlock::setHoldMask(int handIdx, quint8 holdMask)
+{
+    if (_nbCards[handIdx] != Hand::kCardsPerHand) {
+        throw std::runtime_error("Hand is not fully filled");
+    }
+    _holdMasks[handIdx] = holdMask & Hand::kAllHeld;
+}
+
+void HandBlock::setHand(int handIdx, const Hand &hand)
+{
+    for (quint8 cardIdx = 0; cardIdx < hand.nbCards(); ++cardIdx) {
+        _cards[handIdx * Hand::kCardsPerHand + cardIdx] = hand.cardAt(cardIdx);
+    }
+    _nbCards[handIdx]   = hand.nbCards();
+    _holdMasks[handIdx] = hand.holdMask();
+    _cardSets[handIdx]  = hand.cardSet();
+}
+
+Hand HandBlock::hand(int handIdx) const
+{
+    Hand hand;
+    for (quint8 cardIdx = 0; cardIdx < _nbCards[handIdx]; ++cardIdx) {
+        hand.addCard(cardAt(handIdx, cardIdx));
+    }
+    if (_nbCards[handIdx] == Hand::kCardsPerHand) {
+        hand.setHoldMask(_holdMasks[handIdx]);
+    }
+    return hand;
+}
+
+QVector<Hand> HandBlock::hands(int nbHands) const
+{
+    if (nbHands < 0 || nbHands > this->nbHands()) {
+        nbHands = this->nbHands();
+    }
+    QVector<Hand> hands;
+    hands.reserve(nbHands);
+    for (int handIdx = 0; handIdx < nbHands; ++handIdx) {
+        hands.push_back(hand(handIdx));
+    }
+    return hands;
+}
+
+void HandBlock::evaluate(PokerGame *game, quint32 nbCreditsBet, int firstHand, int endHand)
+{
+    game->evaluateCardSets(_cardSets.constData() + firstHand, endHand - firstHand, nbCreditsBet,
+                           _payoutIdx.data() + firstHand, _creditsWon.data() + firstHand);
+}
+
+void HandBlock::setResult(int handIdx, const PokerGame::HandResult &result)
+{
+    _payoutIdx[handIdx]  = result.payoutIdx;
+    _creditsWon[handIdx] = result.creditsWon;
+}
+
+PokerGame::HandResult HandBlock::result(int handIdx) const
+{
+    PokerGame::HandResult result;
+    result.payoutIdx  = _payoutIdx[handIdx];
+    result.creditsWon = _creditsWon[handIdx];
+    return result;
+}
+
+QVector<PokerGame::HandResult> HandBlock::results(int nbHands) const
+{
+    QVector<PokerGame::HandResult> results;
+    results.reserve(nbHands);
+    for (int handIdx = 0; handIdx < nbHands; ++handIdx) {
+        results.push_back(result(handIdx));
+    }
+    return results;
+}
+
+quint32 HandBlock::totalCredits(int firstHand, int endHand) const
+{
+    quint32 total = 0;
+    for (int handIdx = firstHand; handIdx < endHand; ++handIdx) {
+        total += _creditsWon[handIdx];
+    }
+    return total;
+}
+
+QVector<quint32> HandBlock::countRows(int firstHand, int endHand, int nbRows) const
+{
+    QVector<quint32> handsByRow(nbRows, 0);
+    for (int handIdx = firstHand; handIdx < endHand; ++handIdx) {
+        ++handsByRow[_payoutIdx[handIdx]];
+    }
+    return handsByRow;
+}
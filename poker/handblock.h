@@ -0,0 +1,184 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HANDBLOCK_H
+#define HANDBLOCK_H
+
+#include "pokergame.h"
+
+#include <QVector>
+
+/**
+ * @brief A HandBlock holds the hands of a multi-hand game, and what they won, as structure-of-arrays: the cards of
+ *        all the hands one after the other (one byte each), then the hold masks, card sets, paytable rows and payouts
+ *        of the hands, each in its own contiguous array.
+ *
+ *        Drawing, scoring and adding up the winnings of hundreds of hands then stream through a few small arrays,
+ *        and the card sets are handed straight to the game's batch evaluator (see PokerGame::evaluateCardSets). The
+ *        hands are edited in place with the same operations as a Hand, and hand() builds a Hand when one is needed.
+ *
+ * @note  Distinct hands may be written from different threads, as long as the block is not resized meanwhile.
+ */
+class HandBlock
+{
+public:
+    /**
+     * @brief      Creates a block of empty hands
+     *
+     * @param[in]  nbHands        number of hands in the block
+     */
+    explicit HandBlock(int nbHands = 0);
+
+    /**
+     * @brief      Number of hands in the block
+     */
+    int nbHands() const;
+
+    /**
+     * @brief      Empties every hand (no cards, nothing held and no result)
+     */
+    void reset();
+
+    /**
+     * @brief      Adds a card after the cards of a hand (see Hand::addCard)
+     *
+     * @exception  runtime_error will be raised if the hand is full ("Adding card will exceed hand limit")
+     */
+    void addCard(int handIdx, PlayingCard card);
+
+    /**
+     * @brief      Replaces a card of a hand (see Hand::replaceCard)
+     *
+     * @exception  runtime_error will be raised if the card is not in the hand ("Attempt to replace a card not in the
+     *             hand")
+     */
+    void replaceCard(int handIdx, quint8 cardIdx, PlayingCard card);
+
+    /**
+     * @brief      Card at a position of a hand
+     */
+    PlayingCard cardAt(int handIdx, quint8 cardIdx) const;
+
+    /**
+     * @brief      Cards held in a hand, bit i is the card at position i (the layout of Hand::holdMask())
+     */
+    quint8 holdMask(int handIdx) const;
+
+    /**
+     * @brief      Holds (or not) every card of a hand at once
+     *
+     * @exception  runtime_error will be raised if the hand is not full ("Hand is not fully filled")
+     */
+    void setHoldMask(int handIdx, quint8 holdMask);
+
+    /**
+     * @brief      Is a card of a hand held?
+     */
+    bool cardHeld(int handIdx, quint8 cardIdx) const;
+
+    /**
+     * @brief      Set of the cards of a hand (see Hand::cardSet)
+     */
+    quint64 cardSet(int handIdx) const;
+
+    /**
+     * @brief      Copies a hand (its cards and holds) into the block
+     */
+    void setHand(int handIdx, const Hand &hand);
+
+    /**
+     * @brief      Copy of a hand of the block
+     */
+    Hand hand(int handIdx) const;
+
+    /**
+     * @brief      Copies of the first hands of the block
+     *
+     * @param[in]  nbHands        number of hands copied (all of them by default)
+     */
+    QVector<Hand> hands(int nbHands = -1) const;
+
+    /**
+     * @brief      Scores a range of hands through the game's batch evaluator, keeping the result of each hand
+     *
+     * @param[in]  game           game scoring the hands
+     * @param[in]  nbCreditsBet   number of credits bet on each hand
+     * @param[in]  firstHand      first hand of the range
+     * @param[in]  endHand        hand following the last one of the range
+     */
+    void evaluate(PokerGame *game, quint32 nbCreditsBet, int firstHand, int endHand);
+
+    /**
+     * @brief      Sets the result of a hand (e.g. one scored on its own)
+     */
+    void setResult(int handIdx, const PokerGame::HandResult &result);
+
+    /**
+     * @brief      Result of a hand, as set by evaluate() or setResult()
+     */
+    PokerGame::HandResult result(int handIdx) const;
+
+    /**
+     * @brief      Results of the first hands of the block
+     *
+     * @param[in]  nbHands        number of results copied
+     */
+    QVector<PokerGame::HandResult> results(int nbHands) const;
+
+    /**
+     * @brief      Credits won by a range of hands
+     *
+     * @param[in]  firstHand      first hand of the range
+     * @param[in]  endHand        hand following the last one of the range
+     */
+    quint32 totalCredits(int firstHand, int endHand) const;
+
+    /**
+     * @brief      Histogram of the results of a range of hands
+     *
+     * @param[in]  firstHand      first hand of the range
+     * @param[in]  endHand        hand following the last one of the range
+     * @param[in]  nbRows         number of rows of the paytable
+     *
+     * @return     number of hands of the range that hit each paytable row
+     */
+    QVector<quint32> countRows(int firstHand, int endHand, int nbRows) const;
+
+private:
+    QVector<PlayingCard> _cards;        // Hand::kCardsPerHand cards per hand, hand after hand
+    QVector<quint8>      _nbCards;      // How many cards of each hand were added
+    QVector<quint8>      _holdMasks;    // Bit N set if card N of the hand is held
+    QVector<quint64>     _cardSets;     // Union of the cardBit() of the cards of each hand
+    QVector<quint8>      _payoutIdx;    // Paytable row hit by each hand
+    QVector<quint32>     _creditsWon;   // Credits won by each hand
+};
+
+// Trivial accessors are inlined, they are called for every card of every hand
+inline int HandBlock::nbHands() const {return _nbCards.size();}
+
+inline PlayingCard HandBlock::cardAt(int handIdx, quint8 cardIdx) const
+{
+    return _cards[handIdx * Hand::kCardsPerHand + cardIdx];
+}
+
+inline quint8 HandBlock::holdMask(int handIdx) const {return _holdMasks[handIdx];}
+
+inline bool HandBlock::cardHeld(int handIdx, quint8 cardIdx) const {return (_holdMasks[handIdx] >> cardIdx) & 1;}
+
+inline quint64 HandBlock::cardSet(int handIdx) const {return _cardSets[handIdx];}
+
+#endif // HANDBLOCK_H
@@ -0,0 +1,179 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "handcombinatorics.h"
+
+#include <QHash>
+#include <QtAlgorithms>
+
+#include <algorithm>
+
+namespace {
+
+// Largest set size the tables are built for (a full hand)
+const quint8  kMaxChosen  = 5;
+
+const quint64 kSuitMask   = (Q_UINT64_C(1) << PlayingCard::kNbValues) - 1;
+
+struct BinomialTable {
+    quint32 entries[PlayingCard::kNbCards + 1][kMaxChosen + 1];
+
+    BinomialTable()
+    {
+        for (quint8 n = 0; n <= PlayingCard::kNbCards; ++n) {
+            entries[n][0] = 1;
+            for (quint8 k = 1; k <= kMaxChosen; ++k) {
+                entries[n][k] = (n == 0) ? 0 : entries[n - 1][k - 1] + entries[n - 1][k];
+            }
+        }
+    }
+};
+
+const BinomialTable &binomialTable()
+{
+    static const BinomialTable table;
+    return table;
+}
+
+}  // namespace
+
+namespace HandCombinatorics {
+
+quint32 binomial(quint8 n, quint8 k)
+{
+    return binomialTable().entries[n][k];
+}
+
+quint32 colexIndex(quint64 cardSet)
+{
+    const BinomialTable &table = binomialTable();
+    quint32 index = 0;
+    quint8  nbSeen = 0;
+    while (cardSet) {
+        const quint8 cardIdx = static_cast<quint8>(qCountTrailingZeroBits(cardSet));
+        index += table.entries[cardIdx][++nbSeen];
+        cardSet &= cardSet - 1;
+    }
+    return index;
+}
+
+void sortedCards(quint64 dealtCards, quint8 *sortedCards)
+{
+    quint8 nbCards = 0;
+    while (dealtCards && nbCards < Hand::kCardsPerHand) {
+        sortedCards[nbCards++] = static_cast<quint8>(qCountTrailingZeroBits(dealtCards));
+        dealtCards &= dealtCards - 1;
+    }
+    if (nbCards != Hand::kCardsPerHand || dealtCards) {
+        throw std::runtime_error("A deal must have exactly 5 cards");
+    }
+}
+
+void subsetIndices(const quint8 *sortedCards, quint32 *subsetIndices)
+{
+    // binomials[i][k]: contribution of the i-th card when it is the k-th (1-based) card of a subset
+    const BinomialTable &table = binomialTable();
+    quint32 binomials[Hand::kCardsPerHand][Hand::kCardsPerHand + 1];
+    for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+        for (quint8 position = 1; position <= Hand::kCardsPerHand; ++position) {
+            binomials[cardIdx][position] = table.entries[sortedCards[cardIdx]][position];
+        }
+    }
+
+    // Each subset is a smaller subset (without its highest card) plus that card at the last position
+    const quint32 nbSubsets = 1 << Hand::kCardsPerHand;
+    subsetIndices[0] = 0;
+    for (quint32 subset = 1; subset < nbSubsets; ++subset) {
+        const quint8 highestCard = static_cast<quint8>(31 - qCountLeadingZeroBits(subset));
+        const quint8 nbCards     = static_cast<quint8>(qPopulationCount(subset));
+        subsetIndices[subset] = subsetIndices[subset & ~(1 << highestCard)] + binomials[highestCard][nbCards];
+    }
+}
+
+quint64 canonicalKey(quint64 cardSet)
+{
+    quint8 canonicalSuits[4];
+    return canonicalKey(cardSet, canonicalSuits);
+}
+
+quint64 canonicalKey(quint64 cardSet, quint8 *canonicalSuits)
+{
+    quint64 suits[4];
+    quint8  suitOrder[4];
+    for (quint8 suit = 0; suit < 4; ++suit) {
+        suits[suit]     = (cardSet >> (PlayingCard::kNbValues * suit)) & kSuitMask;
+        suitOrder[suit] = suit;
+    }
+    std::sort(suitOrder, suitOrder + 4, [&suits](quint8 lhs, quint8 rhs) {return suits[lhs] < suits[rhs];});
+
+    quint64 key = 0;
+    for (quint8 position = 0; position < 4; ++position) {
+        key |= suits[suitOrder[position]] << (PlayingCard::kNbValues * position);
+        canonicalSuits[suitOrder[position]] = position;
+    }
+    return key;
+}
+
+quint64 canonicalDeal(const Hand &dealtHand, quint8 *cardBits)
+{
+    quint8        canonicalSuits[4];
+    const quint64 key = canonicalKey(dealtHand.cardSet(), canonicalSuits);
+    for (quint8 position = 0; position < Hand::kCardsPerHand; ++position) {
+        const PlayingCard card          = dealtHand.cardAt(position);
+        const quint8      canonicalCard = static_cast<quint8>(canonicalSuits[card.suit()] * PlayingCard::kNbValues +
+                                                              card.value());
+        const quint64     lowerCards    = (Q_UINT64_C(1) << canonicalCard) - 1;
+        cardBits[position] = static_cast<quint8>(1 << qPopulationCount(key & lowerCards));
+    }
+    return key;
+}
+
+QVector<CanonicalHand> canonicalHands()
+{
+    QVector<CanonicalHand>  classes;
+    QHash<quint64, quint32> classOfKey;
+    classes.reserve(kNbCanonicalHands);
+    classOfKey.reserve(kNbCanonicalHands);
+
+    // The first deal (in colex order) of each class is used as its representative
+    for (quint8 c5 = 4; c5 < PlayingCard::kNbCards; ++c5) {
+        for (quint8 c4 = 3; c4 < c5; ++c4) {
+            for (quint8 c3 = 2; c3 < c4; ++c3) {
+                for (quint8 c2 = 1; c2 < c3; ++c2) {
+                    for (quint8 c1 = 0; c1 < c2; ++c1) {
+                        const quint64 cardSet = (Q_UINT64_C(1) << c1) | (Q_UINT64_C(1) << c2) |
+                                                (Q_UINT64_C(1) << c3) | (Q_UINT64_C(1) << c4) |
+                                                (Q_UINT64_C(1) << c5);
+                        const quint64 key = canonicalKey(cardSet);
+
+                        QHash<quint64, quint32>::const_iterator known = classOfKey.constFind(key);
+                        if (known != classOfKey.constEnd()) {
+                            ++classes[known.value()].weight;
+                        } else {
+                            classOfKey.insert(key, static_cast<quint32>(classes.size()));
+                            CanonicalHand newClass = {cardSet, 1};
+                            classes.push_back(newClass);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return classes;
+}
+
+}  // namespace HandCombinatorics
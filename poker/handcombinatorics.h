@@ -0,0 +1,128 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HANDCOMBINATORICS_H
+#define HANDCOMBINATORICS_H
+
+#include "hand.h"
+
+#include <QVector>
+
+/**
+ * @file    Counting helpers for analyzing video poker over the whole space of 5-card hands
+ *
+ *          Card sets are the 52-bit masks of Hand::cardSet(). Sets of up to 5 cards are numbered densely with their
+ *          colexicographic rank, so every 5-card hand has a unique index in [0, kNbFiveCardHands) that can be used to
+ *          address precomputed tables.
+ *
+ *          Two hands that only differ by a renaming of the suits play identically (no game pays more for hearts than
+ *          for spades), so the 2,598,960 possible deals collapse into 134,459 suit-isomorphic classes.
+ */
+namespace HandCombinatorics {
+
+/// Number of distinct 5-card hands that can be dealt from a full French deck: C(52, 5)
+const quint32 kNbFiveCardHands = 2598960;
+
+/// Number of 5-card hands left once suit renamings are ignored
+const quint32 kNbCanonicalHands = 134459;
+
+/**
+ * @brief A representative of a suit-isomorphic class of deals and the number of deals in that class
+ */
+struct CanonicalHand {
+    quint64 cardSet;
+    quint32 weight;
+};
+
+/**
+ * @brief      Number of ways to choose k items among n (0 when k > n)
+ *
+ * @param[in]  n         number of items, at most PlayingCard::kNbCards
+ * @param[in]  k         number of items chosen, at most Hand::kCardsPerHand
+ */
+quint32 binomial(quint8 n, quint8 k);
+
+/**
+ * @brief      Colexicographic rank of a set of cards amongst all sets of the same size
+ *
+ * @param[in]  cardSet   card set of at most Hand::kCardsPerHand cards
+ *
+ * @return     dense index, in [0, C(52, nbCards)), e.g. [0, kNbFiveCardHands) for 5 cards
+ */
+quint32 colexIndex(quint64 cardSet);
+
+/**
+ * @brief      Splits a deal into its cards, in increasing order of index
+ *
+ * @param[in]  dealtCards       5-card set
+ * @param[out] sortedCards      the 5 card indices
+ *
+ * @exception  runtime_error will be raised if the card set does not have exactly 5 cards
+ */
+void sortedCards(quint64 dealtCards, quint8 *sortedCards);
+
+/**
+ * @brief      Colex indices of all 32 subsets of a deal (e.g. to address tables of the sets of 0 to 5 cards)
+ *
+ * @param[in]  sortedCards      the 5 cards of the deal in increasing order (see sortedCards())
+ * @param[out] subsetIndices    colex index of each subset, bit i of the subset number being the i-th card (32 entries)
+ */
+void subsetIndices(const quint8 *sortedCards, quint32 *subsetIndices);
+
+/**
+ * @brief      Key shared by all card sets that only differ by a renaming of the suits
+ *
+ * @param[in]  cardSet   any card set
+ *
+ * @return     the 4 rank masks of the suits, sorted and packed into a 52-bit number
+ */
+quint64 canonicalKey(quint64 cardSet);
+
+/**
+ * @brief      Key shared by all card sets that only differ by a renaming of the suits, and the renaming used
+ *
+ *             The key is itself a card set (suit i holding the i-th smallest rank mask), so card c of suit s maps to
+ *             card canonicalSuits[s] * kNbValues + value of c in the key.
+ *
+ * @param[in]  cardSet          any card set
+ * @param[out] canonicalSuits   suit of the key that each suit of the card set becomes (4 entries)
+ *
+ * @return     the same key as canonicalKey(cardSet)
+ */
+quint64 canonicalKey(quint64 cardSet, quint8 *canonicalSuits);
+
+/**
+ * @brief      Canonical deal (the canonical key) of a dealt hand, and where each card of the hand lands in it
+ *
+ * @param[in]  dealtHand        hand holding 5 real cards
+ * @param[out] cardBits         for each hand position, the bit of its card in a hold over the canonical deal (bit 0 is
+ *                              the lowest card of the canonical deal by index), 5 entries
+ *
+ * @return     canonicalKey(dealtHand.cardSet())
+ */
+quint64 canonicalDeal(const Hand &dealtHand, quint8 *cardBits);
+
+/**
+ * @brief      Enumerates one representative of each suit-isomorphic class of 5-card deals
+ *
+ * @return     kNbCanonicalHands classes, whose weights add up to kNbFiveCardHands
+ */
+QVector<CanonicalHand> canonicalHands();
+
+}  // namespace HandCombinatorics
+
+#endif // HANDCOMBINATORICS_H
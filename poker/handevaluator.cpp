@@ -0,0 +1,311 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "handevaluator.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define HANDEVALUATOR_SSE2
+#endif
+
+namespace {
+
+// Number of card values (ranks) per suit, and therefore the width of a single suit's rank mask in a card set
+const quint32 kRanksPerSuit = PlayingCard::kNbValues;
+const quint32 kSuitMask     = (1u << kRanksPerSuit) - 1;
+
+// Marks rank masks that are not a 5-card straight
+const quint8  kNoStraight   = 0xFF;
+
+// The one straight that does not look like 5 consecutive bits: A-2-3-4-5
+const quint32 kWheelMask    = (1u << PlayingCard::ACE)   | (1u << PlayingCard::TWO) | (1u << PlayingCard::THREE) |
+                              (1u << PlayingCard::FOUR)  | (1u << PlayingCard::FIVE);
+
+/**
+ * @brief Everything the evaluator needs to know about a set of distinct ranks (indexed by a 13-bit rank mask)
+ */
+struct RankInfo {
+    quint8 nbRanks;         // Number of distinct ranks (bits set) in the mask
+    quint8 highRank;        // Highest rank present in the mask
+    quint8 straightHigh;    // Top card of the straight formed by the mask, or kNoStraight
+};
+
+struct RankTable {
+    RankInfo entries[1u << kRanksPerSuit];
+
+    RankTable()
+    {
+        for (quint32 rankMask = 0; rankMask <= kSuitMask; ++rankMask) {
+            RankInfo &info    = entries[rankMask];
+            info.nbRanks      = 0;
+            info.highRank     = 0;
+            info.straightHigh = kNoStraight;
+
+            for (quint8 rank = 0; rank < kRanksPerSuit; ++rank) {
+                if (rankMask & (1u << rank)) {
+                    ++info.nbRanks;
+                    info.highRank = rank;
+                }
+            }
+
+            // Ace-high down to 6-high straights are 5 consecutive bits, the 5-high straight uses the Ace as low card
+            if (rankMask == kWheelMask) {
+                info.straightHigh = PlayingCard::FIVE;
+            } else if (info.nbRanks == 5 && rankMask == (0x1Fu << (info.highRank - 4))) {
+                info.straightHigh = info.highRank;
+            }
+        }
+    }
+};
+
+const RankInfo &rankInfo(quint32 rankMask)
+{
+    // Built once on first use (thread-safe initialization of function-local statics is guaranteed by C++11)
+    static const RankTable table;
+    return table.entries[rankMask];
+}
+
+/*
+ * Batch (SIMD) evaluation
+ *
+ * Every lane of a vector holds one hand, as 32-bit integers. The rank table lookup cannot be vectorized (without
+ * gathers) so the kernel only uses the suit mask bit tricks:
+ *   - no pairs at all means 5 distinct ranks: check for flushes and straights (5 consecutive bits, or the wheel)
+ *   - otherwise the category follows from which of the pairs/trips/quads masks are set (two bits set in the pairs mask
+ *     is either two pair or a full house, told apart by the trips mask)
+ * The defining rank is the highest bit of the relevant mask, found by converting it to a float and reading back the
+ * exponent (exact as the masks are only 13 bits wide).
+ */
+#if defined(__AVX2__)
+struct SimdOps {
+    typedef __m256i Vec;
+    static const int kLanes = 8;
+
+    static Vec  load(const quint32 *src)                {return _mm256_load_si256(reinterpret_cast<const Vec*>(src));}
+    static void store(quint32 *dst, Vec value)          {_mm256_store_si256(reinterpret_cast<Vec*>(dst), value);}
+    static Vec  set1(quint32 value)                     {return _mm256_set1_epi32(static_cast<int>(value));}
+    static Vec  bitAnd(Vec a, Vec b)                    {return _mm256_and_si256(a, b);}
+    static Vec  bitOr(Vec a, Vec b)                     {return _mm256_or_si256(a, b);}
+    static Vec  bitAndNot(Vec a, Vec b)                 {return _mm256_andnot_si256(a, b);}
+    static Vec  equal(Vec a, Vec b)                     {return _mm256_cmpeq_epi32(a, b);}
+    static Vec  sub(Vec a, Vec b)                       {return _mm256_sub_epi32(a, b);}
+    template <int kShift> static Vec shiftRight(Vec a)  {return _mm256_srli_epi32(a, kShift);}
+    static Vec  highBit(Vec a)
+    {
+        return _mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(_mm256_cvtepi32_ps(a)), 23), set1(127));
+    }
+};
+#elif defined(HANDEVALUATOR_SSE2)
+struct SimdOps {
+    typedef __m128i Vec;
+    static const int kLanes = 4;
+
+    static Vec  load(const quint32 *src)                {return _mm_load_si128(reinterpret_cast<const Vec*>(src));}
+    static void store(quint32 *dst, Vec value)          {_mm_store_si128(reinterpret_cast<Vec*>(dst), value);}
+    static Vec  set1(quint32 value)                     {return _mm_set1_epi32(static_cast<int>(value));}
+    static Vec  bitAnd(Vec a, Vec b)                    {return _mm_and_si128(a, b);}
+    static Vec  bitOr(Vec a, Vec b)                     {return _mm_or_si128(a, b);}
+    static Vec  bitAndNot(Vec a, Vec b)                 {return _mm_andnot_si128(a, b);}
+    static Vec  equal(Vec a, Vec b)                     {return _mm_cmpeq_epi32(a, b);}
+    static Vec  sub(Vec a, Vec b)                       {return _mm_sub_epi32(a, b);}
+    template <int kShift> static Vec shiftRight(Vec a)  {return _mm_srli_epi32(a, kShift);}
+    static Vec  highBit(Vec a)
+    {
+        return _mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(_mm_cvtepi32_ps(a)), 23), set1(127));
+    }
+};
+#endif
+
+#if defined(__AVX2__) || defined(HANDEVALUATOR_SSE2)
+#define HANDEVALUATOR_SIMD
+
+// Picks a where the lanes of condition are all ones, b where they are all zeros
+template <typename Ops>
+typename Ops::Vec select(typename Ops::Vec condition, typename Ops::Vec a, typename Ops::Vec b)
+{
+    return Ops::bitOr(Ops::bitAnd(condition, a), Ops::bitAndNot(condition, b));
+}
+
+// Lanes are all ones where value is non-zero
+template <typename Ops>
+typename Ops::Vec nonZero(typename Ops::Vec value)
+{
+    return Ops::bitAndNot(Ops::equal(value, Ops::set1(0)), Ops::set1(0xFFFFFFFF));
+}
+
+/**
+ * @brief Evaluates Ops::kLanes hands given as suit masks, writing the category and rank of each hand
+ */
+template <typename Ops>
+void evaluateLanes(const quint32 *suits0, const quint32 *suits1, const quint32 *suits2, const quint32 *suits3,
+                   quint32 *categories, quint32 *ranks)
+{
+    typedef typename Ops::Vec Vec;
+
+    const Vec suit0 = Ops::load(suits0);
+    const Vec suit1 = Ops::load(suits1);
+    const Vec suit2 = Ops::load(suits2);
+    const Vec suit3 = Ops::load(suits3);
+
+    const Vec lowPair  = Ops::bitOr(suit0, suit1);
+    const Vec highPair = Ops::bitOr(suit2, suit3);
+    const Vec allRanks = Ops::bitOr(lowPair, highPair);
+    const Vec pairs    = Ops::bitOr(Ops::bitOr(Ops::bitAnd(suit0, suit1), Ops::bitAnd(suit2, suit3)),
+                                    Ops::bitAnd(lowPair, highPair));
+    const Vec trips    = Ops::bitOr(Ops::bitAnd(Ops::bitAnd(suit0, suit1), highPair),
+                                    Ops::bitAnd(Ops::bitAnd(suit2, suit3), lowPair));
+    const Vec quads    = Ops::bitAnd(Ops::bitAnd(suit0, suit1), Ops::bitAnd(suit2, suit3));
+
+    // Paired hands, from weakest to strongest so that each test overrides the previous ones
+    const Vec hasPair     = nonZero<Ops>(pairs);
+    const Vec hasTwoPairs = nonZero<Ops>(Ops::bitAnd(pairs, Ops::sub(pairs, Ops::set1(1))));
+    const Vec hasTrips    = nonZero<Ops>(trips);
+    const Vec hasQuads    = nonZero<Ops>(quads);
+
+    Vec category = Ops::set1(HandEvaluator::HIGH_CARD);
+    Vec rankMask = allRanks;
+    category = select<Ops>(hasPair,     Ops::set1(HandEvaluator::ONE_PAIR), category);
+    rankMask = select<Ops>(hasPair,     pairs, rankMask);
+    category = select<Ops>(hasTwoPairs, Ops::set1(HandEvaluator::TWO_PAIR), category);
+    category = select<Ops>(hasTrips,    select<Ops>(hasTwoPairs, Ops::set1(HandEvaluator::FULL_HOUSE),
+                                                    Ops::set1(HandEvaluator::THREE_OF_A_KIND)), category);
+    rankMask = select<Ops>(hasTrips,    trips, rankMask);
+    category = select<Ops>(hasQuads,    Ops::set1(HandEvaluator::FOUR_OF_A_KIND), category);
+    rankMask = select<Ops>(hasQuads,    quads, rankMask);
+
+    // Unpaired hands: straights are 5 consecutive rank bits (or the wheel), flushes have all ranks in a single suit
+    const Vec wheel    = Ops::equal(allRanks, Ops::set1(kWheelMask));
+    const Vec run2     = Ops::bitAnd(allRanks, Ops::template shiftRight<1>(allRanks));
+    const Vec run4     = Ops::bitAnd(run2, Ops::template shiftRight<2>(run2));
+    const Vec run5     = Ops::bitAnd(run4, Ops::template shiftRight<4>(allRanks));
+    const Vec straight = Ops::bitOr(wheel, nonZero<Ops>(run5));
+    const Vec flush    = Ops::bitOr(Ops::bitOr(Ops::equal(allRanks, suit0), Ops::equal(allRanks, suit1)),
+                                    Ops::bitOr(Ops::equal(allRanks, suit2), Ops::equal(allRanks, suit3)));
+    const Vec royal    = Ops::equal(allRanks, Ops::set1(0x1Fu << PlayingCard::TEN));
+
+    Vec unpaired = select<Ops>(straight, Ops::set1(HandEvaluator::STRAIGHT), Ops::set1(HandEvaluator::HIGH_CARD));
+    unpaired = select<Ops>(flush, select<Ops>(straight, select<Ops>(royal, Ops::set1(HandEvaluator::ROYAL_FLUSH),
+                                                                    Ops::set1(HandEvaluator::STRAIGHT_FLUSH)),
+                                              Ops::set1(HandEvaluator::FLUSH)),
+                           unpaired);
+    category = select<Ops>(hasPair, category, unpaired);
+
+    // The wheel is the only hand whose rank is not the highest bit of its mask (the Ace plays low)
+    const Vec rank = select<Ops>(wheel, Ops::set1(PlayingCard::FIVE), Ops::highBit(rankMask));
+
+    Ops::store(categories, category);
+    Ops::store(ranks, rank);
+}
+#endif
+
+HandEvaluator::Evaluation makeEvaluation(HandEvaluator::HandCategory category, quint8 rank)
+{
+    HandEvaluator::Evaluation result;
+    result.category = category;
+    result.rank     = static_cast<PlayingCard::CardValue>(rank);
+    return result;
+}
+
+}  // namespace
+
+namespace HandEvaluator {
+
+Evaluation evaluate(quint64 cardSet)
+{
+    // Split the card set into the rank masks of each suit
+    const quint32 suit0 = static_cast<quint32>(cardSet)                           & kSuitMask;
+    const quint32 suit1 = static_cast<quint32>(cardSet >> (kRanksPerSuit))        & kSuitMask;
+    const quint32 suit2 = static_cast<quint32>(cardSet >> (kRanksPerSuit * 2))    & kSuitMask;
+    const quint32 suit3 = static_cast<quint32>(cardSet >> (kRanksPerSuit * 3))    & kSuitMask;
+
+    const quint32   ranks = suit0 | suit1 | suit2 | suit3;
+    const RankInfo &info  = rankInfo(ranks);
+
+    // Five different ranks: nothing is paired, so it can only be a (straight) flush, a straight or a high card
+    if (info.nbRanks == 5) {
+        const bool flush = (ranks == suit0 || ranks == suit1 || ranks == suit2 || ranks == suit3);
+        if (info.straightHigh != kNoStraight) {
+            if (!flush) {
+                return makeEvaluation(STRAIGHT, info.straightHigh);
+            }
+            return makeEvaluation(info.straightHigh == PlayingCard::ACE ? ROYAL_FLUSH : STRAIGHT_FLUSH,
+                                  info.straightHigh);
+        }
+        return makeEvaluation(flush ? FLUSH : HIGH_CARD, info.highRank);
+    }
+
+    // Ranks appearing in at least 2 suits are (at least) pairs, in at least 3 suits (at least) trips, in all 4 quads
+    const quint32 pairs = (suit0 & suit1) | (suit2 & suit3) | ((suit0 | suit1) & (suit2 | suit3));
+    const quint32 trips = (suit0 & suit1 & (suit2 | suit3)) | (suit2 & suit3 & (suit0 | suit1));
+    const quint32 quads = suit0 & suit1 & suit2 & suit3;
+
+    switch (info.nbRanks) {
+    case 4:
+        return makeEvaluation(ONE_PAIR, rankInfo(pairs).highRank);
+    case 3:
+        if (trips) {
+            return makeEvaluation(THREE_OF_A_KIND, rankInfo(trips).highRank);
+        }
+        return makeEvaluation(TWO_PAIR, rankInfo(pairs).highRank);
+    default:
+        if (quads) {
+            return makeEvaluation(FOUR_OF_A_KIND, rankInfo(quads).highRank);
+        }
+        return makeEvaluation(FULL_HOUSE, rankInfo(trips).highRank);
+    }
+}
+
+Evaluation evaluate(const Hand &hand)
+{
+    return evaluate(hand.cardSet());
+}
+
+void evaluate(const quint64 *cardSets, int nbHands, Evaluation *results)
+{
+    int handIdx = 0;
+
+#ifdef HANDEVALUATOR_SIMD
+    const int kLanes = SimdOps::kLanes;
+    alignas(32) quint32 suits[4][kLanes];
+    alignas(32) quint32 categories[kLanes];
+    alignas(32) quint32 ranks[kLanes];
+
+    for (; handIdx + kLanes <= nbHands; handIdx += kLanes) {
+        for (int lane = 0; lane < kLanes; ++lane) {
+            const quint64 cardSet = cardSets[handIdx + lane];
+            suits[0][lane] = static_cast<quint32>(cardSet)                        & kSuitMask;
+            suits[1][lane] = static_cast<quint32>(cardSet >> (kRanksPerSuit))     & kSuitMask;
+            suits[2][lane] = static_cast<quint32>(cardSet >> (kRanksPerSuit * 2)) & kSuitMask;
+            suits[3][lane] = static_cast<quint32>(cardSet >> (kRanksPerSuit * 3)) & kSuitMask;
+        }
+        evaluateLanes<SimdOps>(suits[0], suits[1], suits[2], suits[3], categories, ranks);
+        for (int lane = 0; lane < kLanes; ++lane) {
+            results[handIdx + lane] = makeEvaluation(static_cast<HandCategory>(categories[lane]),
+                                                     static_cast<quint8>(ranks[lane]));
+        }
+    }
+#endif
+
+    // Whatever does not fill a whole vector (or everything, without SIMD support)
+    for (; handIdx < nbHands; ++handIdx) {
+        results[handIdx] = evaluate(cardSets[handIdx]);
+    }
+}
+
+}  // namespace HandEvaluator
@@ -0,0 +1,98 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HANDEVALUATOR_H
+#define HANDEVALUATOR_H
+
+#include "hand.h"
+
+/**
+ * @file    This file contains a constant-time, allocation-free 5-card hand evaluator
+ *
+ *          Cards are treated as bits in a 52-bit card set (bit index = PlayingCard::index()), which splits neatly into
+ *          four 13-bit rank masks (one per suit). OR-ing the suit masks together gives the set of distinct ranks which
+ *          indexes a precomputed rank table (number of distinct ranks, highest rank, straight detection). Pairs, trips
+ *          and quads fall out of AND-ing the suit masks together and flushes are found by comparing a single suit
+ *          mask to the rank mask. No sorting, no containers, no heap. The same bit tricks (minus the rank table) are
+ *          also available as a batch evaluator that scores several hands per SIMD instruction.
+ *
+ *          The functions in commonhandanalysis.h remain the (slow, but obviously correct) reference implementation
+ *          used to validate this evaluator in the unit tests.
+ */
+namespace HandEvaluator {
+
+/**
+ * @brief Standard poker hand categories, ordered from weakest to strongest. Games decide what each category pays
+ *        (and may split a category further using the Evaluation's rank, see JacksOrBetter).
+ */
+enum HandCategory {
+    HIGH_CARD,
+    ONE_PAIR,
+    TWO_PAIR,
+    THREE_OF_A_KIND,
+    STRAIGHT,
+    FLUSH,
+    FULL_HOUSE,
+    FOUR_OF_A_KIND,
+    STRAIGHT_FLUSH,
+    ROYAL_FLUSH
+};
+
+/**
+ * @brief Result of evaluating a hand: its category and the card value that defines it
+ *
+ *        The rank is the value of the quads, trips (for full houses too) or highest pair. For straights (and straight
+ *        flushes) it is the top card of the run (FIVE for an A-2-3-4-5 "wheel"), otherwise it is the highest card.
+ */
+struct Evaluation {
+    HandCategory           category;
+    PlayingCard::CardValue rank;
+};
+
+/**
+ * @brief      Evaluates a set of exactly 5 distinct cards
+ *
+ * @param[in]  cardSet   52-bit card set, see Hand::cardSet() for the bit layout
+ *
+ * @return     category and defining rank of the hand
+ */
+Evaluation evaluate(quint64 cardSet);
+
+/**
+ * @brief      Evaluates a fully-populated hand
+ *
+ * @param[in]  hand      A hand holding Hand::kCardsPerHand real cards
+ *
+ * @return     category and defining rank of the hand
+ */
+Evaluation evaluate(const Hand &hand);
+
+/**
+ * @brief      Evaluates many 5-card sets at once, giving exactly the same results as calling evaluate() on each
+ *
+ *             Hands are scored several at a time with SIMD instructions when the library is built for a CPU that has
+ *             them (8 hands per instruction with AVX2, 4 with SSE2), otherwise this falls back to the scalar evaluator.
+ *
+ * @param[in]  cardSets  array of nbHands 52-bit card sets (see Hand::cardSet())
+ * @param[in]  nbHands   number of card sets to evaluate
+ * @param[out] results   array receiving nbHands evaluations, in the same order as cardSets
+ */
+void evaluate(const quint64 *cardSets, int nbHands, Evaluation *results);
+
+}  // namespace HandEvaluator
+
+#endif // HANDEVALUATOR_H
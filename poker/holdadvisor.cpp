@@ -0,0 +1,118 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holdadvisor.h"
+
+#include "handcombinatorics.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QtAlgorithms>
+
+namespace {
+
+// Canonical keys only use the low kNbCards bits, the bet goes above them in the cache key
+const quint8 kBetShift = PlayingCard::kNbCards;
+
+}  // namespace
+
+HoldAdvisor::HoldAdvisor(PokerGame *game) : _game(game) {}
+
+HoldAdvisor::Advice HoldAdvisor::advise(const Hand &dealtHand, quint32 nbCreditsBet)
+{
+    if (qPopulationCount(dealtHand.cardSet()) != Hand::kCardsPerHand) {
+        throw std::runtime_error("A deal must have exactly 5 cards");
+    }
+
+    // Where each card of the hand lands in the canonical deal of its class
+    quint8        canonicalBit[Hand::kCardsPerHand];
+    const quint64 canonicalDeal = HandCombinatorics::canonicalDeal(dealtHand, canonicalBit);
+
+    Advice canonicalAdvice;
+    {
+        QMutexLocker locker(&_lock);
+        const quint64 cacheKey = canonicalDeal | (static_cast<quint64>(nbCreditsBet) << kBetShift);
+        QHash<quint64, Advice>::const_iterator cached = _advice.constFind(cacheKey);
+        if (cached != _advice.constEnd()) {
+            canonicalAdvice = cached.value();
+        } else {
+            HoldSolver::HoldValues holdValues;
+            const StrategyTable   *table = strategyTable(nbCreditsBet);
+            if (table != nullptr) {
+                holdValues = table->solve(canonicalDeal);
+            } else {
+                QSharedPointer<HoldSolver> &solver = _solvers[nbCreditsBet];
+                if (solver.isNull()) {
+                    solver.reset(new HoldSolver(_game, nbCreditsBet));
+                }
+                holdValues = solver->solve(canonicalDeal);
+            }
+            canonicalAdvice.holdMask      = holdValues.bestHold;
+            canonicalAdvice.expectedValue = holdValues.expectedValue[holdValues.bestHold];
+            _advice.insert(cacheKey, canonicalAdvice);
+        }
+    }
+
+    // Bring the hold back to the positions of the hand
+    Advice advice;
+    advice.holdMask      = 0;
+    advice.expectedValue = canonicalAdvice.expectedValue;
+    for (quint8 position = 0; position < Hand::kCardsPerHand; ++position) {
+        if (canonicalAdvice.holdMask & canonicalBit[position]) {
+            advice.holdMask |= static_cast<quint8>(1 << position);
+        }
+    }
+    return advice;
+}
+
+void HoldAdvisor::useStrategyTables(const QString &directory)
+{
+    QMutexLocker locker(&_lock);
+    _strategyDirectory = directory;
+    _tables.clear();
+}
+
+const StrategyTable *HoldAdvisor::strategyTable(quint32 nbCreditsBet)
+{
+    if (_strategyDirectory.isEmpty()) {
+        return nullptr;
+    }
+
+    QHash<quint32, QSharedPointer<StrategyTable>>::const_iterator known = _tables.constFind(nbCreditsBet);
+    if (known != _tables.constEnd()) {
+        return known.value().data();
+    }
+
+    // Only looked for once per bet, so a missing or stale file does not cost anything after the first deal
+    QSharedPointer<StrategyTable> table;
+    const QString fileName = QDir(_strategyDirectory).filePath(StrategyTable::fileName(*_game, nbCreditsBet));
+    if (QFile::exists(fileName)) {
+        try {
+            table.reset(new StrategyTable(fileName, *_game, nbCreditsBet));
+        } catch (std::runtime_error &exception) {
+            qDebug() << "WARNING: " << fileName << ": " << exception.what();
+        }
+    }
+    _tables.insert(nbCreditsBet, table);
+    return table.data();
+}
+
+int HoldAdvisor::nbCachedHands() const
+{
+    QMutexLocker locker(&_lock);
+    return _advice.size();
+}
@@ -0,0 +1,93 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLDADVISOR_H
+#define HOLDADVISOR_H
+
+#include "holdsolver.h"
+#include "strategytable.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+
+/**
+ * @brief HoldAdvisor finds the best hold of dealt hands for any bet of a game, remembering the advice it gave.
+ *
+ *        Holds are looked up in the precomputed StrategyTable of the bet when one is available (see useStrategyTables),
+ *        otherwise the HoldSolver of the bet is built (which takes about a second) the first time a hand is advised
+ *        for that bet. Advice is cached per suit-isomorphic class of deals, so a deal that is a suit renaming of an
+ *        earlier one is answered with a single hash lookup. All the methods are thread-safe.
+ */
+class HoldAdvisor
+{
+public:
+    /**
+     * @brief The best hold of a deal and what it is worth
+     */
+    struct Advice {
+        quint8 holdMask;        // Cards to hold, bit i is the card at position i (the layout of Hand::holdMask())
+        double expectedValue;   // Expected credits won by the hold
+    };
+
+    /**
+     * @brief      Creates an advisor for a game (no table is built until the first hand is advised)
+     *
+     * @param[in]  game           game whose paytables are used, it must outlive the advisor
+     */
+    explicit HoldAdvisor(PokerGame *game);
+
+    /**
+     * @brief      Finds the hold with the highest expected value
+     *
+     * @param[in]  dealtHand      hand holding 5 real cards
+     * @param[in]  nbCreditsBet   number of credits bet on the hand (1 to 5)
+     *
+     * @exception  runtime_error will be raised if the bet is not valid for the game or the hand is not complete
+     *
+     * @return     the best hold of the hand
+     */
+    Advice advise(const Hand &dealtHand, quint32 nbCreditsBet);
+
+    /**
+     * @brief      Looks for strategy files (named as StrategyTable::fileName) in a directory from now on. Files that
+     *             are missing or do not match the paytable are reported once and the solver is used instead.
+     *
+     * @param[in]  directory      directory of the strategy files, empty to always use the solver
+     */
+    void useStrategyTables(const QString &directory);
+
+    /**
+     * @brief      Number of deal classes (across all bets) whose advice is cached
+     */
+    int nbCachedHands() const;
+
+private:
+    // Strategy table of a bet, loaded on first use (null if there is none), _lock must be held
+    const StrategyTable *strategyTable(quint32 nbCreditsBet);
+
+    PokerGame                                     *_game;
+    mutable QMutex                                 _lock;
+    QHash<quint32, QSharedPointer<HoldSolver>>     _solvers;   // Solver of each bet, built on first use
+    QString                                        _strategyDirectory;
+    QHash<quint32, QSharedPointer<StrategyTable>>  _tables;    // Strategy table of each bet already looked for
+
+    // Best hold of each canonical deal (bits in card order of the canonical key), keyed by canonical key and bet
+    QHash<quint64, Advice>                         _advice;
+};
+
+#endif // HOLDADVISOR_H
@@ -0,0 +1,147 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "holdsolver.h"
+
+#include "drawoutcomes.h"
+#include "handcombinatorics.h"
+
+#include <QtAlgorithms>
+
+const quint8 HoldSolver::kNbHolds;
+
+namespace {
+
+// Cards left in the deck once a hand has been dealt
+const quint8 kNbRemaining = PlayingCard::kNbCards - Hand::kCardsPerHand;
+
+// Credits paid by each row of the game's paytable for the bet (this also validates the bet)
+QVector<quint32> payTableCredits(const DrawOutcomes &outcomes, const PokerGame &game, quint32 nbCreditsBet)
+{
+    if (!outcomes.matches(game)) {
+        throw std::runtime_error("The paytable rows are not the ones of the draw outcomes");
+    }
+    QVector<QPair<const QString, int>> payTable;
+    game.currentPayTable(nbCreditsBet, payTable);
+    QVector<quint32> credits;
+    for (const QPair<const QString, int> &row : payTable) {
+        credits.push_back(static_cast<quint32>(row.second));
+    }
+    return credits;
+}
+
+}  // namespace
+
+HoldSolver::HoldSolver(PokerGame *game, quint32 nbCreditsBet) : HoldSolver(DrawOutcomes(game), *game, nbCreditsBet)
+{
+}
+
+HoldSolver::HoldSolver(const DrawOutcomes &outcomes, const PokerGame &game, quint32 nbCreditsBet)
+    : HoldSolver(outcomes, payTableCredits(outcomes, game, nbCreditsBet), nbCreditsBet)
+{
+}
+
+HoldSolver::HoldSolver(const DrawOutcomes &outcomes, const QVector<quint32> &creditsByRow, quint32 nbCreditsBet)
+    : _nbCreditsBet   (nbCreditsBet),
+      _payoutRowByHand(outcomes.rowByHand()),
+      _creditsByRow   (creditsByRow)
+{
+    if (_creditsByRow.size() != outcomes.nbRows()) {
+        throw std::runtime_error("The paytable must pay each row of the draw outcomes");
+    }
+
+    // Total payout of the hands containing each set: the hands of each row times what the row pays
+    for (quint8 nbCards = 0; nbCards < Hand::kCardsPerHand; ++nbCards) {
+        const quint32 nbSets = HandCombinatorics::binomial(PlayingCard::kNbCards, nbCards);
+        _supersetCredits[nbCards].resize(nbSets);
+        for (quint32 setIndex = 0; setIndex < nbSets; ++setIndex) {
+            const quint32 *counts  = outcomes.supersetCounts(nbCards, setIndex);
+            quint64        credits = 0;
+            for (int row = 0; row < _creditsByRow.size(); ++row) {
+                credits += static_cast<quint64>(counts[row]) * _creditsByRow[row];
+            }
+            _supersetCredits[nbCards][setIndex] = credits;
+        }
+    }
+}
+
+HoldSolver::HoldValues HoldSolver::solve(quint64 dealtCards) const
+{
+    quint8 cards[Hand::kCardsPerHand];
+    HandCombinatorics::sortedCards(dealtCards, cards);
+    quint32 subsets[kNbHolds];
+    HandCombinatorics::subsetIndices(cards, subsets);
+
+    // Total payout of all the hands containing each subset of the deal (the whole deal being a hand of its own)
+    qint64 credits[kNbHolds];
+    for (quint8 subset = 0; subset < kNbHolds - 1; ++subset) {
+        const quint8 nbCards = static_cast<quint8>(qPopulationCount(subset));
+        credits[subset] = static_cast<qint64>(_supersetCredits[nbCards][subsets[subset]]);
+    }
+    credits[kNbHolds - 1] = payout(subsets[kNbHolds - 1]);
+
+    // Superset Moebius transform: remove the hands containing any dealt card that is not held
+    for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+        const quint8 cardBit = static_cast<quint8>(1 << cardIdx);
+        for (quint8 hold = 0; hold < kNbHolds; ++hold) {
+            if (!(hold & cardBit)) {
+                credits[hold] -= credits[hold | cardBit];
+            }
+        }
+    }
+
+    HoldValues holdValues;
+    holdValues.bestHold = 0;
+    for (quint8 hold = 0; hold < kNbHolds; ++hold) {
+        const quint8 nbToDraw = Hand::kCardsPerHand - static_cast<quint8>(qPopulationCount(hold));
+        holdValues.expectedValue[hold] = static_cast<double>(credits[hold]) /
+                                         HandCombinatorics::binomial(kNbRemaining, nbToDraw);
+        if (holdValues.expectedValue[hold] > holdValues.expectedValue[holdValues.bestHold]) {
+            holdValues.bestHold = hold;
+        }
+    }
+    return holdValues;
+}
+
+HoldSolver::HoldValues HoldSolver::solve(const Hand &dealtHand) const
+{
+    // Where each hand position lands once the cards are sorted by index
+    quint8 sortedBit[Hand::kCardsPerHand];
+    for (quint8 position = 0; position < Hand::kCardsPerHand; ++position) {
+        const quint64 lowerCards = dealtHand.cardAt(position).cardBit() - 1;
+        sortedBit[position] = static_cast<quint8>(1 << qPopulationCount(dealtHand.cardSet() & lowerCards));
+    }
+    return byHandPosition(solve(dealtHand.cardSet()), sortedBit);
+}
+
+HoldSolver::HoldValues HoldSolver::byHandPosition(const HoldValues &byCardOrder, const quint8 *cardBits)
+{
+    HoldValues byPosition;
+    for (quint8 hold = 0; hold < kNbHolds; ++hold) {
+        quint8 sortedHold = 0;
+        for (quint8 position = 0; position < Hand::kCardsPerHand; ++position) {
+            if (hold & (1 << position)) {
+                sortedHold |= cardBits[position];
+            }
+        }
+        byPosition.expectedValue[hold] = byCardOrder.expectedValue[sortedHold];
+        if (sortedHold == byCardOrder.bestHold) {
+            byPosition.bestHold = hold;
+        }
+    }
+    return byPosition;
+}
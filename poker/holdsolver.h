@@ -0,0 +1,153 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HOLDSOLVER_H
+#define HOLDSOLVER_H
+
+#include "pokergame.h"
+
+#include <QVector>
+
+class DrawOutcomes;
+
+/**
+ * @brief HoldSolver computes the expected value of all 32 holds of a dealt hand at once, in a few microseconds.
+ *
+ *        Instead of enumerating the draws of every hold, the solver precomputes (once per game and bet) the total
+ *        payout of all 5-card hands containing each set of 0 to 4 cards, plus the payout of each 5-card hand itself.
+ *        For a deal D, the draws of the hold H are exactly the 5-card hands F with F & D == H, so by
+ *        inclusion-exclusion:
+ *
+ *            sum over draws of H = sum over H <= S <= D of (-1)^(|S| - |H|) * total(S)
+ *
+ *        All 32 holds then come out of 32 table lookups followed by a superset Moebius transform over the 5 cards.
+ *
+ *        The totals are the dot product of the DrawOutcomes counts (hands of each paytable row containing each set)
+ *        with the payouts of the bet. Building the solver from a game counts the outcomes first, which scores every
+ *        hand through the game's evaluateHands() (any PokerGame subclass works) and takes about a second on a desktop.
+ *        Building it from counts at hand (e.g. to try paytables) takes milliseconds. Solving only reads the tables, so
+ *        a solver can be shared between threads.
+ */
+class HoldSolver
+{
+public:
+    /// Number of ways to hold (or not) each of the 5 dealt cards
+    static const quint8 kNbHolds = 32;
+
+    /**
+     * @brief Expected value (in credits) of every hold of a deal, and the best of them
+     *
+     *        Hold patterns are bitmasks over the 5 dealt cards. When solving a card set, bit 0 is the lowest card by
+     *        PlayingCard::index() and bit 4 the highest. When solving a Hand, bit i is the card at position i (the
+     *        same layout as Hand::holdMask()). 0 discards everything, 31 holds the whole deal.
+     */
+    struct HoldValues {
+        double expectedValue[kNbHolds];
+        quint8 bestHold;
+    };
+
+    /**
+     * @brief      Builds the payout tables of the game for the requested bet
+     *
+     * @param[in]  game           game whose paytable is used (only used during construction)
+     * @param[in]  nbCreditsBet   number of credits bet on each hand (1 to 5)
+     *
+     * @exception  runtime_error will be raised if the bet is not valid for the game
+     */
+    HoldSolver(PokerGame *game, quint32 nbCreditsBet);
+
+    /**
+     * @brief      Builds the payout tables of a paytable from draw outcomes counted beforehand
+     *
+     * @param[in]  outcomes       draw outcomes counted for a game with the same paytable rows (only used during
+     *                            construction)
+     * @param[in]  game           game whose payouts are used (only used during construction)
+     * @param[in]  nbCreditsBet   number of credits bet on each hand (1 to 5)
+     *
+     * @exception  runtime_error will be raised if the bet is not valid or the paytable rows were not the ones counted
+     */
+    HoldSolver(const DrawOutcomes &outcomes, const PokerGame &game, quint32 nbCreditsBet);
+
+    /**
+     * @brief      Builds the payout tables of arbitrary row payouts from draw outcomes counted beforehand (e.g. to try
+     *             paytables that no game has yet)
+     *
+     * @param[in]  outcomes       draw outcomes of the rows (only used during construction)
+     * @param[in]  creditsByRow   credits paid by each row of the outcomes for the bet
+     * @param[in]  nbCreditsBet   number of credits bet on each hand, the expected values being in credits
+     *
+     * @exception  runtime_error will be raised if there is not one payout per row
+     */
+    HoldSolver(const DrawOutcomes &outcomes, const QVector<quint32> &creditsByRow, quint32 nbCreditsBet);
+
+    /**
+     * @brief      Computes the expected value of all 32 holds of a deal
+     *
+     * @param[in]  dealtCards     5-card set (see Hand::cardSet())
+     *
+     * @exception  runtime_error will be raised if the card set does not have exactly 5 cards
+     *
+     * @return     the value of each hold (bits in card index order) and the best one (the first one found on ties)
+     */
+    HoldValues solve(quint64 dealtCards) const;
+
+    /**
+     * @brief      Computes the expected value of all 32 holds of a dealt hand
+     *
+     * @param[in]  dealtHand      hand holding 5 real cards
+     *
+     * @return     the value of each hold (bits in hand position order) and the best one
+     */
+    HoldValues solve(const Hand &dealtHand) const;
+
+    /**
+     * @brief      Moves the hold bits of values computed over a card set to the positions of a hand
+     *
+     * @param[in]  byCardOrder    values of a card set (bits in card index order)
+     * @param[in]  cardBits       for each hand position, the bit of its card in byCardOrder (5 entries)
+     *
+     * @return     the same values, bit i of each hold being the card at position i
+     */
+    static HoldValues byHandPosition(const HoldValues &byCardOrder, const quint8 *cardBits);
+
+    /**
+     * @brief      Credits paid by a 5-card hand
+     *
+     * @param[in]  handIndex      colex index of the hand (see HandCombinatorics::colexIndex)
+     */
+    quint32 payout(quint32 handIndex) const;
+
+    /**
+     * @brief      Credits bet on each hand
+     */
+    quint32 creditsBet() const;
+
+private:
+    quint32          _nbCreditsBet;
+    QVector<quint8>  _payoutRowByHand;   // Paytable row hit by each 5-card hand, indexed by colex index
+    QVector<quint32> _creditsByRow;      // Credits paid by each paytable row for the bet
+
+    // Total credits paid by all the 5-card hands containing a set of k cards, [k][colex index of the set] (k < 5)
+    QVector<quint64> _supersetCredits[Hand::kCardsPerHand];
+};
+
+// Trivial accessors are inlined, payout() is looked up for every possible draw
+inline quint32 HoldSolver::payout(quint32 handIndex) const {return _creditsByRow[_payoutRowByHand[handIndex]];}
+
+inline quint32 HoldSolver::creditsBet() const {return _nbCreditsBet;}
+
+#endif // HOLDSOLVER_H
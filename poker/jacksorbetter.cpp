@@ -17,7 +17,7 @@
 
 #include "jacksorbetter.h"
 
-#include "commonhandanalysis.h"
+#include "handevaluator.h"
 
 JacksOrBetter::JacksOrBetter() : PokerGame("Jacks or Better")
 {
@@ -35,47 +35,98 @@ JacksOrBetter::JacksOrBetter() : PokerGame("Jacks or Better")
     };
 }
 
+namespace {
+// Maps an evaluated hand onto the Jacks or Better paytable (see the indices in the constructor)
+quint8 payoutIndex(const HandEvaluator::Evaluation &evaluation)
+{
+    switch (evaluation.category) {
+    case HandEvaluator::ROYAL_FLUSH:
+        return 0;
+    case HandEvaluator::STRAIGHT_FLUSH:
+        return 1;
+    case HandEvaluator::FOUR_OF_A_KIND:
+        return 2;
+    case HandEvaluator::FULL_HOUSE:
+        return 3;
+    case HandEvaluator::FLUSH:
+        return 4;
+    case HandEvaluator::STRAIGHT:
+        return 5;
+    case HandEvaluator::THREE_OF_A_KIND:
+        return 6;
+    case HandEvaluator::TWO_PAIR:
+        return 7;
+    case HandEvaluator::ONE_PAIR:
+        // Only a pair of Jacks, Queens, Kings or Aces pays
+        return (evaluation.rank >= PlayingCard::JACK) ? 8 : 9;
+    case HandEvaluator::HIGH_CARD:
+    default:
+        return 9;
+    }
+}
+
+// Hands are passed to the batch evaluator in chunks of this many card sets
+const int kBatchSize = 64;
+}  // namespace
+
 void JacksOrBetter::determineHandAndWin(const Hand &gameHand,
                                         quint32     nbCreditsBet,
                                         QString    &winningHand,
                                         quint32    &creditsWon)
 {
-    // Convert the hand to a vector so that algorithms can re-sort the cards as needed to efficiently determine wins
-    QVector<PlayingCard> singleHand = gameHand.handToVector();
+    const HandResult result = evaluateHand(gameHand, nbCreditsBet);
+    winningHand = _handPayouts[result.payoutIdx].handString;
+    creditsWon  = result.creditsWon;
+}
+
+PokerGame::HandResult JacksOrBetter::evaluateHand(const Hand &gameHand, quint32 nbCreditsBet)
+{
+    // A single table-driven pass over the cards determines the best category the hand makes
+    const quint8 payoutIdx = payoutIndex(HandEvaluator::evaluate(gameHand));
+
+    HandResult result;
+    result.payoutIdx  = payoutIdx;
+    result.creditsWon = _handPayouts[payoutIdx].payoutCredits[nbCreditsBet - 1];
+    return result;
+}
+
+void JacksOrBetter::evaluateHands(const Hand *gameHands, int nbHands, quint32 nbCreditsBet, HandResult *results)
+{
+    quint64                   cardSets[kBatchSize];
+    HandEvaluator::Evaluation evaluations[kBatchSize];
+
+    for (int firstHand = 0; firstHand < nbHands; firstHand += kBatchSize) {
+        const int nbInBatch = qMin(kBatchSize, nbHands - firstHand);
+        for (int handIdx = 0; handIdx < nbInBatch; ++handIdx) {
+            cardSets[handIdx] = gameHands[firstHand + handIdx].cardSet();
+        }
+
+        HandEvaluator::evaluate(cardSets, nbInBatch, evaluations);
+
+        for (int handIdx = 0; handIdx < nbInBatch; ++handIdx) {
+            const quint8 payoutIdx = payoutIndex(evaluations[handIdx]);
+            results[firstHand + handIdx].payoutIdx  = payoutIdx;
+            results[firstHand + handIdx].creditsWon = _handPayouts[payoutIdx].payoutCredits[nbCreditsBet - 1];
+        }
+    }
+}
+
+void JacksOrBetter::evaluateCardSets(const quint64 *cardSets,
+                                     int            nbHands,
+                                     quint32        nbCreditsBet,
+                                     quint8        *payoutIdx,
+                                     quint32       *creditsWon)
+{
+    HandEvaluator::Evaluation evaluations[kBatchSize];
 
-    // Sort the hand by order of highest to lowest card rank, as required by some hand analysis algorithms
-    HandAnalysis::sortHandVector(singleHand);
+    for (int firstHand = 0; firstHand < nbHands; firstHand += kBatchSize) {
+        const int nbInBatch = qMin(kBatchSize, nbHands - firstHand);
+        HandEvaluator::evaluate(cardSets + firstHand, nbInBatch, evaluations);
 
-    // Go in order of best hand to nothing, so we ensure the best winnings possible are met
-    if (HandAnalysis::RoyalFlush(singleHand)) {
-        winningHand = _handPayouts[0].handString;
-        creditsWon  = _handPayouts[0].payoutCredits[nbCreditsBet - 1];
-    } else if (HandAnalysis::StraightFlush(singleHand)) {
-        winningHand = _handPayouts[1].handString;
-        creditsWon  = _handPayouts[1].payoutCredits[nbCreditsBet - 1];
-    } else if (HandAnalysis::FourOfAKind(singleHand)) {
-        winningHand = _handPayouts[2].handString;
-        creditsWon  = _handPayouts[2].payoutCredits[nbCreditsBet - 1];
-    } else if (HandAnalysis::FullHouse(singleHand)) {
-        winningHand = _handPayouts[3].handString;
-        creditsWon  = _handPayouts[3].payoutCredits[nbCreditsBet - 1];
-    } else if (HandAnalysis::Flush(singleHand)) {
-        winningHand = _handPayouts[4].handString;
-        creditsWon  = _handPayouts[4].payoutCredits[nbCreditsBet - 1];
-    } else if (HandAnalysis::Straight(singleHand)) {
-        winningHand = _handPayouts[5].handString;
-        creditsWon  = _handPayouts[5].payoutCredits[nbCreditsBet - 1];
-    } else if (HandAnalysis::ThreeOfAKind(singleHand)) {
-        winningHand = _handPayouts[6].handString;
-        creditsWon  = _handPayouts[6].payoutCredits[nbCreditsBet - 1];
-    } else if (HandAnalysis::TwoPair(singleHand)) {
-        winningHand = _handPayouts[7].handString;
-        creditsWon  = _handPayouts[7].payoutCredits[nbCreditsBet - 1];
-    } else if (HandAnalysis::JacksOrBetter(singleHand)) {
-        winningHand = _handPayouts[8].handString;
-        creditsWon  = _handPayouts[8].payoutCredits[nbCreditsBet - 1];
-    } else {
-        winningHand = _handPayouts[9].handString;
-        creditsWon  = _handPayouts[9].payoutCredits[nbCreditsBet - 1];
+        for (int handIdx = 0; handIdx < nbInBatch; ++handIdx) {
+            const quint8 payoutRow = payoutIndex(evaluations[handIdx]);
+            payoutIdx[firstHand + handIdx]  = payoutRow;
+            creditsWon[firstHand + handIdx] = _handPayouts[payoutRow].payoutCredits[nbCreditsBet - 1];
+        }
     }
 }
@@ -50,6 +50,38 @@ public:
      * @param[out] creditsWon     Number of credits the player is entitled to win based on the gameHand and bet
      */
     void determineHandAndWin(const Hand &gameHand, quint32 nbCreditsBet, QString &winningHand, quint32 &creditsWon);
+
+    /**
+     * @brief evaluateHand Analyzes a hand against the Jacks-or-Better game rules and the requested bet amount
+     *
+     * @param[in]  gameHand       A set of PlayingCards comprising the player's hand construction
+     * @param[in]  nbCreditsBet   Number of credits the player has staked for gameHand
+     *
+     * @return     paytable row hit by the hand (see the table above, the last row is "no win") and credits won
+     */
+    HandResult evaluateHand(const Hand &gameHand, quint32 nbCreditsBet);
+
+    /**
+     * @brief evaluateHands Analyzes many hands at once using the batch (SIMD) hand evaluator
+     *
+     * @param[in]  gameHands      Array of nbHands hands to analyze
+     * @param[in]  nbHands        Number of hands in gameHands (and results)
+     * @param[in]  nbCreditsBet   Number of credits the player has staked on each hand
+     * @param[out] results        Array receiving the result of each hand, in the same order as gameHands
+     */
+    void evaluateHands(const Hand *gameHands, int nbHands, quint32 nbCreditsBet, HandResult *results);
+
+    /**
+     * @brief evaluateCardSets Analyzes many card sets at once, handing them straight to the batch hand evaluator
+     *
+     * @param[in]  cardSets       Array of nbHands card sets of 5 cards each
+     * @param[in]  nbHands        Number of card sets (and results)
+     * @param[in]  nbCreditsBet   Number of credits the player has staked on each hand
+     * @param[out] payoutIdx      Array receiving the paytable row hit by each hand
+     * @param[out] creditsWon     Array receiving the credits won by each hand
+     */
+    void evaluateCardSets(const quint64 *cardSets, int nbHands, quint32 nbCreditsBet, quint8 *payoutIdx,
+                          quint32 *creditsWon);
 };
 
 #endif // JACKSORBETTER_H
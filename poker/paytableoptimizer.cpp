@@ -0,0 +1,224 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "paytableoptimizer.h"
+
+#include "holdsolver.h"
+
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief Scores candidate paytables until there are none left, one candidate at a time
+ */
+class CandidateWorker : public QRunnable
+{
+public:
+    CandidateWorker(const PaytableOptimizer         &optimizer,
+                    const QVector<QVector<quint32>> &payTables,
+                    double                          *returns,
+                    QAtomicInt                      &nextPayTable)
+        : _optimizer(optimizer), _payTables(payTables), _returns(returns), _nextPayTable(nextPayTable)
+    {
+    }
+
+    void run()
+    {
+        for (;;) {
+            const int payTableIdx = _nextPayTable.fetchAndAddRelaxed(1);
+            if (payTableIdx >= _payTables.size()) {
+                return;
+            }
+            _returns[payTableIdx] = _optimizer.computeReturn(_payTables[payTableIdx]);
+        }
+    }
+
+private:
+    const PaytableOptimizer         &_optimizer;
+    const QVector<QVector<quint32>> &_payTables;
+    double                          *_returns;
+    QAtomicInt                      &_nextPayTable;
+};
+
+}  // namespace
+
+PaytableOptimizer::PaytableOptimizer(const DrawOutcomes &outcomes, const PokerGame &baseGame, quint32 nbCreditsBet)
+    : _outcomes    (outcomes),
+      _nbCreditsBet(nbCreditsBet),
+      _searchRadius(1),
+      _deals       (HandCombinatorics::canonicalHands())
+{
+    if (!outcomes.matches(baseGame)) {
+        throw std::runtime_error("The paytable rows are not the ones of the draw outcomes");
+    }
+
+    QVector<QPair<const QString, int>> payTable;
+    baseGame.currentPayTable(nbCreditsBet, payTable);
+    for (const QPair<const QString, int> &row : payTable) {
+        _rowNames.push_back(row.first);
+        _baseCredits.push_back(static_cast<quint32>(row.second));
+    }
+
+    // The royal flush and the losing hands are not searched unless asked
+    _fixedRows.fill(false, _baseCredits.size());
+    _fixedRows[0]                     = true;
+    _fixedRows[_fixedRows.size() - 1] = true;
+}
+
+void PaytableOptimizer::setRowFixed(int row, bool fixed)
+{
+    if (row < 0 || row >= _fixedRows.size()) {
+        throw std::runtime_error("No such row in the paytable");
+    }
+    _fixedRows[row] = fixed;
+}
+
+void PaytableOptimizer::setSearchRadius(quint32 radius)
+{
+    _searchRadius = radius;
+}
+
+QVector<PaytableOptimizer::Candidate> PaytableOptimizer::search(double targetReturn, int nbCandidates,
+                                                                int nbThreads) const
+{
+    if (nbThreads <= 0) {
+        nbThreads = QThread::idealThreadCount();
+    }
+
+    const QVector<QVector<quint32>> payTables = candidatePayTables();
+    QVector<double> returns(payTables.size());
+    QAtomicInt      nextPayTable(0);
+
+    QThreadPool workers;
+    workers.setMaxThreadCount(nbThreads);
+    for (int workerIdx = 0; workerIdx < nbThreads; ++workerIdx) {
+        workers.start(new CandidateWorker(*this, payTables, returns.data(), nextPayTable));
+    }
+    workers.waitForDone();
+
+    // Closest to the target first (ties keep the search order)
+    QVector<int> ranking(payTables.size());
+    for (int payTableIdx = 0; payTableIdx < ranking.size(); ++payTableIdx) {
+        ranking[payTableIdx] = payTableIdx;
+    }
+    std::stable_sort(ranking.begin(), ranking.end(), [&returns, targetReturn](int left, int right) {
+        return std::fabs(returns[left] - targetReturn) < std::fabs(returns[right] - targetReturn);
+    });
+
+    QVector<Candidate> candidates;
+    for (int rank = 0; rank < qMin(nbCandidates, ranking.size()); ++rank) {
+        Candidate candidate;
+        candidate.creditsByRow = payTables[ranking[rank]];
+        candidate.gameReturn   = returns[ranking[rank]];
+        candidate.variance     = computeVariance(candidate.creditsByRow);
+        candidates.push_back(candidate);
+    }
+    return candidates;
+}
+
+double PaytableOptimizer::computeReturn(const QVector<quint32> &creditsByRow) const
+{
+    const HoldSolver solver(_outcomes, creditsByRow, _nbCreditsBet);
+
+    double totalValue = 0.0;
+    for (const HandCombinatorics::CanonicalHand &deal : _deals) {
+        const HoldSolver::HoldValues holds = solver.solve(deal.cardSet);
+        totalValue += deal.weight * holds.expectedValue[holds.bestHold];
+    }
+    return totalValue / HandCombinatorics::kNbFiveCardHands / _nbCreditsBet;
+}
+
+double PaytableOptimizer::computeVariance(const QVector<quint32> &creditsByRow) const
+{
+    // Paying the square of the credits values the second moment of each hold, the player still picks the best EV
+    QVector<quint32> squaredCredits;
+    for (quint32 credits : creditsByRow) {
+        squaredCredits.push_back(credits * credits);
+    }
+    const HoldSolver solver       (_outcomes, creditsByRow,   _nbCreditsBet);
+    const HoldSolver squaredSolver(_outcomes, squaredCredits, _nbCreditsBet);
+
+    double totalValue   = 0.0;
+    double totalSquares = 0.0;
+    for (const HandCombinatorics::CanonicalHand &deal : _deals) {
+        const HoldSolver::HoldValues holds   = solver.solve(deal.cardSet);
+        const HoldSolver::HoldValues squares = squaredSolver.solve(deal.cardSet);
+        totalValue   += deal.weight * holds.expectedValue[holds.bestHold];
+        totalSquares += deal.weight * squares.expectedValue[holds.bestHold];
+    }
+    const double meanReturn = totalValue / HandCombinatorics::kNbFiveCardHands / _nbCreditsBet;
+    const double meanSquare = totalSquares / HandCombinatorics::kNbFiveCardHands / _nbCreditsBet / _nbCreditsBet;
+    return meanSquare - meanReturn * meanReturn;
+}
+
+QVector<QVector<quint32>> PaytableOptimizer::candidatePayTables() const
+{
+    // Payouts each row can take: the base one for fixed rows, whole credits per credit bet around it otherwise
+    QVector<QVector<quint32>> choices(_baseCredits.size());
+    for (int row = 0; row < _baseCredits.size(); ++row) {
+        if (_fixedRows[row]) {
+            choices[row].push_back(_baseCredits[row]);
+            continue;
+        }
+        const quint32 lowestStep = qMin(_searchRadius, _baseCredits[row] / _nbCreditsBet);
+        for (quint32 credits = _baseCredits[row] - lowestStep * _nbCreditsBet;
+             credits <= _baseCredits[row] + _searchRadius * _nbCreditsBet;
+             credits += _nbCreditsBet) {
+            choices[row].push_back(credits);
+        }
+    }
+
+    // Odometer over the choices of every row, keeping the paytables that pay the rows in the base order
+    QVector<QVector<quint32>> payTables;
+    QVector<int>              choiceIdx(_baseCredits.size(), 0);
+    for (;;) {
+        QVector<quint32> payTable(_baseCredits.size());
+        for (int row = 0; row < payTable.size(); ++row) {
+            payTable[row] = choices[row][choiceIdx[row]];
+        }
+
+        bool sameOrder = true;
+        for (int row = 0; row < payTable.size() && sameOrder; ++row) {
+            for (int otherRow = 0; otherRow < payTable.size(); ++otherRow) {
+                if (_baseCredits[row] > _baseCredits[otherRow] && payTable[row] < payTable[otherRow]) {
+                    sameOrder = false;
+                    break;
+                }
+            }
+        }
+        if (sameOrder) {
+            payTables.push_back(payTable);
+        }
+
+        int row = 0;
+        while (row < choiceIdx.size() && ++choiceIdx[row] == choices[row].size()) {
+            choiceIdx[row++] = 0;
+        }
+        if (row == choiceIdx.size()) {
+            return payTables;
+        }
+    }
+}
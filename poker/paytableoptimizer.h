@@ -0,0 +1,143 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef PAYTABLEOPTIMIZER_H
+#define PAYTABLEOPTIMIZER_H
+
+#include "drawoutcomes.h"
+#include "handcombinatorics.h"
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief PaytableOptimizer searches the payouts around a base paytable for the ones whose return under optimal play is
+ *        the closest to a target, instead of editing a game's _handPayouts and recomputing its return by hand.
+ *
+ *        Each free row of the paytable moves by up to searchRadius() credits per credit bet from the base payout. The
+ *        first row (the royal flush, its payout drives the jackpot) and the last one (the losing hands) stay fixed by
+ *        default, and candidates must pay the rows in the same order as the base paytable (a row never pays less than
+ *        one the base paid less).
+ *
+ *        Every candidate is scored exactly: a HoldSolver is built from the shared DrawOutcomes counts (no hand is
+ *        scored) and solves all the suit-isomorphic deals, which takes a few tens of milliseconds. Candidates are
+ *        spread over a thread pool, one candidate per thread at a time. The variance is only computed for the
+ *        candidates reported.
+ */
+class PaytableOptimizer
+{
+public:
+    /**
+     * @brief A paytable tried by the search
+     */
+    struct Candidate {
+        QVector<quint32> creditsByRow;   // Credits paid by each row for the bet
+        double           gameReturn;     // Expected credits won per credit bet, under optimal play
+        double           variance;       // Variance of the credits won per credit bet (0 until reported by search)
+    };
+
+    /**
+     * @brief      Prepares a search around the paytable of a game
+     *
+     * @param[in]  outcomes       draw outcomes counted for the game's paytable rows, it must outlive the optimizer
+     * @param[in]  baseGame       game whose paytable the search starts from (only used during construction)
+     * @param[in]  nbCreditsBet   number of credits bet on each hand (1 to 5)
+     *
+     * @exception  runtime_error will be raised if the bet is not valid or the paytable rows were not the ones counted
+     */
+    PaytableOptimizer(const DrawOutcomes &outcomes, const PokerGame &baseGame, quint32 nbCreditsBet);
+
+    /**
+     * @brief      Keeps a row at its base payout, or lets the search move it
+     *
+     * @param[in]  row            index of the row in the paytable
+     * @param[in]  fixed          true to keep the base payout
+     */
+    void setRowFixed(int row, bool fixed);
+
+    /**
+     * @brief      Sets how far (in credits per credit bet) the payout of each free row may move from its base payout
+     */
+    void setSearchRadius(quint32 radius);
+
+    /**
+     * @brief      Scores every candidate paytable and keeps those closest to a target return
+     *
+     * @param[in]  targetReturn   return wanted (e.g. 0.97 for a 97% game)
+     * @param[in]  nbCandidates   number of candidates to report
+     * @param[in]  nbThreads      number of threads scoring candidates (defaults to one per core)
+     *
+     * @return     the best candidates, closest return first, with their variance
+     */
+    QVector<Candidate> search(double targetReturn, int nbCandidates, int nbThreads = 0) const;
+
+    /**
+     * @brief      Computes the return of row payouts under optimal play (on the calling thread)
+     *
+     * @param[in]  creditsByRow   credits paid by each row for the bet
+     *
+     * @exception  runtime_error will be raised if there is not one payout per row
+     *
+     * @return     expected credits won per credit bet
+     */
+    double computeReturn(const QVector<quint32> &creditsByRow) const;
+
+    /**
+     * @brief      Computes the variance of the credits won per credit bet under optimal play (on the calling thread)
+     *
+     * @param[in]  creditsByRow   credits paid by each row for the bet
+     *
+     * @exception  runtime_error will be raised if there is not one payout per row
+     */
+    double computeVariance(const QVector<quint32> &creditsByRow) const;
+
+    /**
+     * @brief      Credits paid by each row of the base paytable for the bet
+     */
+    const QVector<quint32> &baseCredits() const;
+
+    /**
+     * @brief      Name of each row of the paytable
+     */
+    const QVector<QString> &rowNames() const;
+
+    /**
+     * @brief      How far the payout of each free row may move from its base payout
+     */
+    quint32 searchRadius() const;
+
+private:
+    // Every paytable of the search space that pays the rows in the base order
+    QVector<QVector<quint32>> candidatePayTables() const;
+
+    const DrawOutcomes                       &_outcomes;
+    quint32                                   _nbCreditsBet;
+    QVector<QString>                          _rowNames;
+    QVector<quint32>                          _baseCredits;
+    QVector<bool>                             _fixedRows;
+    quint32                                   _searchRadius;
+    QVector<HandCombinatorics::CanonicalHand> _deals;   // One deal per suit-isomorphic class, with its weight
+};
+
+inline const QVector<quint32> &PaytableOptimizer::baseCredits() const {return _baseCredits;}
+
+inline const QVector<QString> &PaytableOptimizer::rowNames() const {return _rowNames;}
+
+inline quint32 PaytableOptimizer::searchRadius() const {return _searchRadius;}
+
+#endif // PAYTABLEOPTIMIZER_H
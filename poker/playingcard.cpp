@@ -17,21 +17,19 @@
 
 #include "playingcard.h"
 
-PlayingCard::PlayingCard() : _null(true) {}
+// Out-of-line definitions for the in-class constants (needed whenever they are bound to a reference)
+const quint8 PlayingCard::kNbCards;
+const quint8 PlayingCard::kNbValues;
+const quint8 PlayingCard::kNullCard;
+const quint8 PlayingCard::kSuitShift;
+const quint8 PlayingCard::kValueMask;
 
-PlayingCard::PlayingCard(CardSuit cardSuit, CardValue cardValue) : _null(false), _suit(cardSuit), _value(cardValue) {}
+PlayingCard::PlayingCard() : _packed(kNullCard) {}
 
-bool PlayingCard::fakeCard() const {return _null;}
+PlayingCard::PlayingCard(CardSuit cardSuit, CardValue cardValue)
+    : _packed(static_cast<quint8>((cardSuit << kSuitShift) | cardValue)) {}
 
-bool PlayingCard::operator==(const PlayingCard &card) const
+PlayingCard PlayingCard::fromIndex(quint8 cardIdx)
 {
-    return ((this->fakeCard() && card.fakeCard()) ||
-            (!this->fakeCard() &&
-             !card.fakeCard()  &&
-             (this->suit() == card.suit()) &&
-             (this->value() == card.value())));
+    return PlayingCard(static_cast<CardSuit>(cardIdx / kNbValues), static_cast<CardValue>(cardIdx % kNbValues));
 }
-
-PlayingCard::CardSuit PlayingCard::suit() const   {return _suit;}
-
-PlayingCard::CardValue PlayingCard::value() const {return _value;}
@@ -18,12 +18,24 @@
 #ifndef PLAYINGCARD_H
 #define PLAYINGCARD_H
 
+#include <QtGlobal>
+
 /**
  * @brief A PlayingCard is a single card with a suit and value (rank)
+ *
+ * @note  The suit and value are packed into a single byte (value in the low nibble, suit in the 2 bits above it) so
+ *        cards can be copied, stored in hands/decks and sent through queued signals for next to nothing. Each real card
+ *        also maps to a unique index in [0, kNbCards) which is used for 64-bit card set bitmasks (see Hand::cardSet).
  */
 class PlayingCard
 {
 public:
+    /// Number of distinct cards (suit x value), card indices are in the range [0, kNbCards)
+    static const quint8 kNbCards = 52;
+
+    /// Number of distinct values in a suit
+    static const quint8 kNbValues = 13;
+
     enum CardSuit {
         DIAMOND,
         HEART,
@@ -57,6 +69,15 @@ public:
      */
     explicit PlayingCard(CardSuit cardSuit, CardValue cardValue);
 
+    /**
+     * @brief      Builds a card back from its index (the inverse of index())
+     *
+     * @param[in]  cardIdx   index in the range [0, kNbCards)
+     *
+     * @return     the card at cardIdx
+     */
+    static PlayingCard fromIndex(quint8 cardIdx);
+
     /**
      * @brief      Determines if this instance is an actual card and not a 'placeholder'
      *
@@ -68,6 +89,7 @@ public:
      * @brief operator == overloading for use by the Deck's removeCard() feature
      */
     bool operator==(const PlayingCard &card) const;
+    bool operator!=(const PlayingCard &card) const;
 
     /**
      * @brief      Getter for card's suit
@@ -83,10 +105,44 @@ public:
      */
     CardValue value() const;
 
+    /**
+     * @brief      Unique position of the card in a full deck: suit * kNbValues + value
+     *
+     * @return     card index in the range [0, kNbCards), meaningless for fake cards
+     */
+    quint8 index() const;
+
+    /**
+     * @brief      Single-bit mask of the card for 64-bit card sets
+     *
+     * @return     1 << index(), or 0 for a fake (placeholder) card
+     */
+    quint64 cardBit() const;
+
 private:
-    bool      _null;    // A null card can be used to have a placeholder in a hand (say for holding at a position)
-    CardSuit  _suit;
-    CardValue _value;
+    // Marker for a null card, which can be used to have a placeholder in a hand (say for holding at a position)
+    static const quint8 kNullCard  = 0xFF;
+    static const quint8 kSuitShift = 4;
+    static const quint8 kValueMask = 0x0F;
+
+    quint8 _packed;     // Value in bits 0-3, suit in bits 4-5 (or kNullCard)
 };
 
+/*
+ * The accessors below are on the hot path of every hand evaluation and deck operation, so they are kept inline
+ */
+inline bool PlayingCard::fakeCard() const {return _packed == kNullCard;}
+
+inline bool PlayingCard::operator==(const PlayingCard &card) const {return _packed == card._packed;}
+
+inline bool PlayingCard::operator!=(const PlayingCard &card) const {return _packed != card._packed;}
+
+inline PlayingCard::CardSuit PlayingCard::suit() const {return static_cast<CardSuit>(_packed >> kSuitShift);}
+
+inline PlayingCard::CardValue PlayingCard::value() const {return static_cast<CardValue>(_packed & kValueMask);}
+
+inline quint8 PlayingCard::index() const {return static_cast<quint8>(suit() * kNbValues + value());}
+
+inline quint64 PlayingCard::cardBit() const {return fakeCard() ? 0 : (Q_UINT64_C(1) << index());}
+
 #endif // PLAYINGCARD_H
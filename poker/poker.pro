@@ -26,24 +26,57 @@ DESTDIR   = $$OUT_PWD/../bin
 INCLUDEPATH += $$PWD
 DEPENDPATH  += $$PWD
 
+# The batch hand evaluator uses SSE2 on x86-64 out of the box (other CPUs get the scalar version). Uncomment to score
+# 8 hands at a time with AVX2 instead, only if every machine running the build supports it!
+#QMAKE_CXXFLAGS += -mavx2
+
 HEADERS += \
     $$PWD/account.h \
     $$PWD/bonuspoker.h \
     $$PWD/commonhandanalysis.h \
     $$PWD/deck.h \
+    $$PWD/deckview.h \
+    $$PWD/drawoutcomes.h \
+    $$PWD/drawsampler.h \
     $$PWD/gameorchestrator.h \
+    $$PWD/gamesnapshot.h \
     $$PWD/hand.h \
+    $$PWD/handblock.h \
+    $$PWD/handcombinatorics.h \
+    $$PWD/handevaluator.h \
+    $$PWD/holdadvisor.h \
+    $$PWD/holdsolver.h \
     $$PWD/jacksorbetter.h \
+    $$PWD/paytableoptimizer.h \
     $$PWD/playingcard.h \
-    $$PWD/pokergame.h
+    $$PWD/pokergame.h \
+    $$PWD/randomengine.h \
+    $$PWD/randompool.h \
+    $$PWD/returncalculator.h \
+    $$PWD/strategytable.h \
+    $$PWD/turbosimulator.h
 
 SOURCES += \
     $$PWD/account.cpp \
     $$PWD/bonuspoker.cpp \
     $$PWD/commonhandanalysis.cpp \
     $$PWD/deck.cpp \
+    $$PWD/deckview.cpp \
+    $$PWD/drawoutcomes.cpp \
+    $$PWD/drawsampler.cpp \
     $$PWD/gameorchestrator.cpp \
     $$PWD/hand.cpp \
+    $$PWD/handblock.cpp \
+    $$PWD/handcombinatorics.cpp \
+    $$PWD/handevaluator.cpp \
+    $$PWD/holdadvisor.cpp \
+    $$PWD/holdsolver.cpp \
     $$PWD/jacksorbetter.cpp \
+    $$PWD/paytableoptimizer.cpp \
     $$PWD/playingcard.cpp \
-    $$PWD/pokergame.cpp
+    $$PWD/pokergame.cpp \
+    $$PWD/randomengine.cpp \
+    $$PWD/randompool.cpp \
+    $$PWD/returncalculator.cpp \
+    $$PWD/strategytable.cpp \
+    $$PWD/turbosimulator.cpp
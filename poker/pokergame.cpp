@@ -19,6 +19,9 @@
 
 #include "commonhandanalysis.h"
 
+#include <QByteArray>
+#include <QtAlgorithms>
+
 PokerGame::PokerGame(const QString &gameName) : _gameName(gameName) {}
 
 PokerGame::~PokerGame() {}
@@ -44,3 +47,76 @@ void PokerGame::currentPayTable(quint32 nbCreditsPerBet, QVector<QPair<const QSt
         payoutForBet.push_back(handPayout);
     }
 }
+
+quint64 PokerGame::payTableHash() const
+{
+    const quint64 kFnvOffsetBasis = Q_UINT64_C(14695981039346656037);
+    const quint64 kFnvPrime       = Q_UINT64_C(1099511628211);
+
+    quint64 hash = kFnvOffsetBasis;
+    for (const Parameters &singleHand : _handPayouts) {
+        // The row name (with its terminating zero, so "AB" + "C" differs from "A" + "BC")...
+        const QByteArray handName = singleHand.handString.toUtf8();
+        for (int byteIdx = 0; byteIdx <= handName.size(); ++byteIdx) {
+            hash = (hash ^ static_cast<quint8>(byteIdx < handName.size() ? handName[byteIdx] : 0)) * kFnvPrime;
+        }
+
+        // ... and its payouts, byte by byte
+        for (quint32 credits : singleHand.payoutCredits) {
+            for (int byteIdx = 0; byteIdx < 4; ++byteIdx) {
+                hash = (hash ^ ((credits >> (8 * byteIdx)) & 0xFF)) * kFnvPrime;
+            }
+        }
+    }
+    return hash;
+}
+
+PokerGame::HandResult PokerGame::evaluateHand(const Hand &gameHand, quint32 nbCreditsBet)
+{
+    QString winningHand;
+    HandResult result;
+    determineHandAndWin(gameHand, nbCreditsBet, winningHand, result.creditsWon);
+
+    for (int payoutIdx = 0; payoutIdx < _handPayouts.size(); ++payoutIdx) {
+        if (_handPayouts[payoutIdx].handString == winningHand) {
+            result.payoutIdx = static_cast<quint8>(payoutIdx);
+            return result;
+        }
+    }
+    throw std::runtime_error("Winning hand not found in the paytable");
+}
+
+void PokerGame::evaluateHands(const Hand *gameHands, int nbHands, quint32 nbCreditsBet, HandResult *results)
+{
+    for (int handIdx = 0; handIdx < nbHands; ++handIdx) {
+        results[handIdx] = evaluateHand(gameHands[handIdx], nbCreditsBet);
+    }
+}
+
+void PokerGame::evaluateCardSets(const quint64 *cardSets,
+                                 int            nbHands,
+                                 quint32        nbCreditsBet,
+                                 quint8        *payoutIdx,
+                                 quint32       *creditsWon)
+{
+    for (int handIdx = 0; handIdx < nbHands; ++handIdx) {
+        // The order of the cards does not matter to the score, they are added by index
+        Hand    gameHand;
+        quint64 cards = cardSets[handIdx];
+        while (cards != 0) {
+            gameHand.addCard(PlayingCard::fromIndex(static_cast<quint8>(qCountTrailingZeroBits(cards))));
+            cards &= cards - 1;
+        }
+        const HandResult result = evaluateHand(gameHand, nbCreditsBet);
+        payoutIdx[handIdx]  = result.payoutIdx;
+        creditsWon[handIdx] = result.creditsWon;
+    }
+}
+
+const QString &PokerGame::handString(quint8 payoutIdx) const
+{
+    if (payoutIdx >= _handPayouts.size()) {
+        throw std::runtime_error("Paytable row out of range");
+    }
+    return _handPayouts[payoutIdx].handString;
+}
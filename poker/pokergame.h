@@ -23,8 +23,8 @@
 #include <QVector>
 
 /**
- * @brief This is a pure-virtual class representing the core functions of a game. This should be inherited from to
- *        create an actual game.
+ * @brief This is an abstract class representing the core functions of a game. This should be inherited from to
+ *        create an actual game: determineHandAndWin() must be implemented, and evaluateHand() should be too for speed.
  */
 class PokerGame
 {
@@ -52,6 +52,12 @@ public:
      */
     const QString gameName() const;
 
+    /// Result of analyzing a single hand: which row of the paytable it hit and what that row pays for the bet
+    struct HandResult {
+        quint8  payoutIdx;
+        quint32 creditsWon;
+    };
+
     /**
      * @brief determineHandAndWin is where the actual hand evaluation logic and winnings shall be determined by classes
      *                            inheriting from this abstract base class
@@ -66,6 +72,65 @@ public:
                                      QString    &winningHand,
                                      quint32    &creditsWon) = 0;
 
+    /**
+     * @brief evaluateHand is the allocation-free counterpart of determineHandAndWin used when playing (possibly many)
+     *                     hands: no strings are produced, only the index of the paytable row that was hit
+     *
+     * @note  the default implementation adapts determineHandAndWin (finding the row by its string), so games should
+     *        override this directly for speed.
+     *
+     * @param[in]  gameHand       A set of PlayingCards comprising the player's hand construction
+     * @param[in]  nbCreditsBet   Number of credits the player has staked for gameHand
+     *
+     * @exception  runtime_error will be raised if determineHandAndWin names no row of the paytable
+     *
+     * @return     paytable row (see handString()) and number of credits won
+     */
+    virtual HandResult evaluateHand(const Hand &gameHand, quint32 nbCreditsBet);
+
+    /**
+     * @brief evaluateHands scores a whole set of hands (e.g. all hands of a multi-hand draw) in one call
+     *
+     * @note  the default implementation calls evaluateHand for every hand, games with a batch evaluator should override
+     *        this to score the hands together.
+     *
+     * @param[in]  gameHands      Array of nbHands hands to analyze
+     * @param[in]  nbHands        Number of hands in gameHands (and results)
+     * @param[in]  nbCreditsBet   Number of credits the player has staked on each hand
+     * @param[out] results        Array receiving the result of each hand, in the same order as gameHands
+     */
+    virtual void evaluateHands(const Hand *gameHands, int nbHands, quint32 nbCreditsBet, HandResult *results);
+
+    /**
+     * @brief evaluateCardSets scores hands given as card sets (see Hand::cardSet()), writing the paytable row and the
+     *                         payout of each hand to separate arrays (the layout of a HandBlock)
+     *
+     * @note  the default implementation builds a Hand from each card set and calls evaluateHand, games with a batch
+     *        evaluator should override this to score the card sets directly.
+     *
+     * @param[in]  cardSets       Array of nbHands card sets of 5 cards each
+     * @param[in]  nbHands        Number of card sets (and results)
+     * @param[in]  nbCreditsBet   Number of credits the player has staked on each hand
+     * @param[out] payoutIdx      Array receiving the paytable row hit by each hand
+     * @param[out] creditsWon     Array receiving the credits won by each hand
+     */
+    virtual void evaluateCardSets(const quint64 *cardSets,
+                                  int            nbHands,
+                                  quint32        nbCreditsBet,
+                                  quint8        *payoutIdx,
+                                  quint32       *creditsWon);
+
+    /**
+     * @brief handString looks up the display name of a paytable row (as returned by evaluateHand)
+     *
+     * @param[in]  payoutIdx      row of the paytable
+     *
+     * @exception  runtime_error will be raised if the row does not exist ("Paytable row out of range")
+     *
+     * @return     name of the hand, empty for the (last) non-winning row
+     */
+    const QString &handString(quint8 payoutIdx) const;
+
     /**
      * @brief currentPayTable extracts the relevant paytable based on how many credits would be bet
      *
@@ -74,6 +139,19 @@ public:
      */
     void currentPayTable(quint32 nbCredPerBet, QVector<QPair<const QString, int> > &payoutForBet) const;
 
+    /**
+     * @brief nbPayTableRows counts the rows of the paytable, the last (non-winning) one included
+     */
+    int nbPayTableRows() const;
+
+    /**
+     * @brief payTableHash fingerprints the whole paytable (every row name and payout of every bet), so anything
+     *        precomputed from a paytable can tell when it has been edited
+     *
+     * @return 64-bit FNV-1a hash of _handPayouts
+     */
+    quint64 payTableHash() const;
+
 protected:
     /**
      * @brief creditBetValid determines if a valid number of credits was requested for betting
@@ -93,4 +171,6 @@ private:
     QString             _gameName;
 };
 
+inline int PokerGame::nbPayTableRows() const {return _handPayouts.size();}
+
 #endif // POKERGAME_H
@@ -0,0 +1,251 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "randomengine.h"
+
+#include <exception>
+
+const int RandomEngine::kBufferSize;
+const int ChaCha20Engine::kKeyWords;
+const int ChaCha20Engine::kNonceWords;
+const int ChaCha20Engine::kBlockWords;
+const int PhiloxEngine::kKeyWords;
+const int PhiloxEngine::kBlockWords;
+
+namespace {
+
+inline quint64 rotateLeft(quint64 value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline quint32 rotateLeft(quint32 value, int bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// splitmix64 step, recommended to expand a 64-bit seed into the xoshiro state
+quint64 splitMix64(quint64 &seed)
+{
+    quint64 value = (seed += Q_UINT64_C(0x9E3779B97F4A7C15));
+    value = (value ^ (value >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+    value = (value ^ (value >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+    return value ^ (value >> 31);
+}
+
+inline void quarterRound(quint32 *state, int a, int b, int c, int d)
+{
+    state[a] += state[b];
+    state[d]  = rotateLeft(state[d] ^ state[a], 16);
+    state[c] += state[d];
+    state[b]  = rotateLeft(state[b] ^ state[c], 12);
+    state[a] += state[b];
+    state[d]  = rotateLeft(state[d] ^ state[a], 8);
+    state[c] += state[d];
+    state[b]  = rotateLeft(state[b] ^ state[c], 7);
+}
+
+}  // namespace
+
+QSharedPointer<RandomEngine> RandomEngine::create(EngineType type)
+{
+    QRandomGenerator *entropy = QRandomGenerator::system();
+    switch (type) {
+    case XOSHIRO256:
+        return QSharedPointer<RandomEngine>(new Xoshiro256Engine(entropy->generate64()));
+    case CHACHA20: {
+        quint32 key[ChaCha20Engine::kKeyWords];
+        quint32 nonce[ChaCha20Engine::kNonceWords];
+        entropy->generate(key, key + ChaCha20Engine::kKeyWords);
+        entropy->generate(nonce, nonce + ChaCha20Engine::kNonceWords);
+        return QSharedPointer<RandomEngine>(new ChaCha20Engine(key, nonce, 0));
+    }
+    case PHILOX:
+        return QSharedPointer<RandomEngine>(new PhiloxEngine(entropy->generate64(), 0, 0));
+    default:
+        return QSharedPointer<RandomEngine>(new QtRandomEngine(entropy->generate()));
+    }
+}
+
+RandomEngine::EngineType RandomEngine::typeFromName(const QString &name)
+{
+    if (name == "qt") {
+        return QT_GENERATOR;
+    } else if (name == "xoshiro") {
+        return XOSHIRO256;
+    } else if (name == "chacha20") {
+        return CHACHA20;
+    } else if (name == "philox") {
+        return PHILOX;
+    }
+    throw std::runtime_error("Unknown random engine");
+}
+
+RandomEngine::RandomEngine() : _nextValue(kBufferSize)
+{
+}
+
+RandomEngine::~RandomEngine()
+{
+}
+
+QtRandomEngine::QtRandomEngine(quint32 seed) : _generator(seed)
+{
+}
+
+RandomEngine::EngineType QtRandomEngine::type() const
+{
+    return QT_GENERATOR;
+}
+
+void QtRandomEngine::refill(quint32 *values, int count)
+{
+    _generator.fillRange(values, count);
+}
+
+Xoshiro256Engine::Xoshiro256Engine(quint64 seed)
+{
+    for (quint64 &word : _state) {
+        word = splitMix64(seed);
+    }
+}
+
+RandomEngine::EngineType Xoshiro256Engine::type() const
+{
+    return XOSHIRO256;
+}
+
+void Xoshiro256Engine::refill(quint32 *values, int count)
+{
+    for (int valueIdx = 0; valueIdx < count; valueIdx += 2) {
+        const quint64 result  = rotateLeft(_state[1] * 5, 7) * 9;
+        const quint64 shifted = _state[1] << 17;
+        _state[2] ^= _state[0];
+        _state[3] ^= _state[1];
+        _state[1] ^= _state[2];
+        _state[0] ^= _state[3];
+        _state[2] ^= shifted;
+        _state[3]  = rotateLeft(_state[3], 45);
+
+        values[valueIdx]     = static_cast<quint32>(result);
+        values[valueIdx + 1] = static_cast<quint32>(result >> 32);
+    }
+}
+
+ChaCha20Engine::ChaCha20Engine(const quint32 *key, const quint32 *nonce, quint32 counter) : _counter(counter)
+{
+    for (int wordIdx = 0; wordIdx < kKeyWords; ++wordIdx) {
+        _key[wordIdx] = key[wordIdx];
+    }
+    for (int wordIdx = 0; wordIdx < kNonceWords; ++wordIdx) {
+        _nonce[wordIdx] = nonce[wordIdx];
+    }
+}
+
+RandomEngine::EngineType ChaCha20Engine::type() const
+{
+    return CHACHA20;
+}
+
+void ChaCha20Engine::refill(quint32 *values, int count)
+{
+    for (int blockStart = 0; blockStart < count; blockStart += kBlockWords) {
+        // "expand 32-byte k", the key, the block counter and the nonce
+        quint32 input[kBlockWords] = {0x61707865, 0x3320646E, 0x79622D32, 0x6B206574,
+                                      _key[0], _key[1], _key[2], _key[3], _key[4], _key[5], _key[6], _key[7],
+                                      _counter, _nonce[0], _nonce[1], _nonce[2]};
+        quint32 *block = values + blockStart;
+        for (int wordIdx = 0; wordIdx < kBlockWords; ++wordIdx) {
+            block[wordIdx] = input[wordIdx];
+        }
+
+        // 20 rounds: 10 times a column round then a diagonal round
+        for (int doubleRound = 0; doubleRound < 10; ++doubleRound) {
+            quarterRound(block, 0, 4,  8, 12);
+            quarterRound(block, 1, 5,  9, 13);
+            quarterRound(block, 2, 6, 10, 14);
+            quarterRound(block, 3, 7, 11, 15);
+            quarterRound(block, 0, 5, 10, 15);
+            quarterRound(block, 1, 6, 11, 12);
+            quarterRound(block, 2, 7,  8, 13);
+            quarterRound(block, 3, 4,  9, 14);
+        }
+        for (int wordIdx = 0; wordIdx < kBlockWords; ++wordIdx) {
+            block[wordIdx] += input[wordIdx];
+        }
+
+        // Move on to the next block, and to the next nonce after the last block of this one
+        if (++_counter == 0) {
+            ++_nonce[0];
+        }
+    }
+}
+
+PhiloxEngine::PhiloxEngine(quint64 seed, quint64 gameNumber, quint32 handIndex)
+{
+    _key[0]     = static_cast<quint32>(seed);
+    _key[1]     = static_cast<quint32>(seed >> 32);
+    _counter[0] = 0;
+    _counter[1] = handIndex;
+    _counter[2] = static_cast<quint32>(gameNumber);
+    _counter[3] = static_cast<quint32>(gameNumber >> 32);
+}
+
+RandomEngine::EngineType PhiloxEngine::type() const
+{
+    return PHILOX;
+}
+
+void PhiloxEngine::generateBlock(const quint32 *counter, const quint32 *key, quint32 *output)
+{
+    // Multipliers and Weyl key increments of Philox4x32
+    const quint32 kMultiplier0 = 0xD2511F53;
+    const quint32 kMultiplier1 = 0xCD9E8D57;
+    const quint32 kKeyStep0    = 0x9E3779B9;
+    const quint32 kKeyStep1    = 0xBB67AE85;
+
+    quint32 block[kBlockWords]  = {counter[0], counter[1], counter[2], counter[3]};
+    quint32 roundKey[kKeyWords] = {key[0], key[1]};
+    for (int round = 0; round < 10; ++round) {
+        const quint64 product0 = static_cast<quint64>(kMultiplier0) * block[0];
+        const quint64 product1 = static_cast<quint64>(kMultiplier1) * block[2];
+        const quint32 next[kBlockWords] = {static_cast<quint32>(product1 >> 32) ^ block[1] ^ roundKey[0],
+                                           static_cast<quint32>(product1),
+                                           static_cast<quint32>(product0 >> 32) ^ block[3] ^ roundKey[1],
+                                           static_cast<quint32>(product0)};
+        for (int wordIdx = 0; wordIdx < kBlockWords; ++wordIdx) {
+            block[wordIdx] = next[wordIdx];
+        }
+        roundKey[0] += kKeyStep0;
+        roundKey[1] += kKeyStep1;
+    }
+    for (int wordIdx = 0; wordIdx < kBlockWords; ++wordIdx) {
+        output[wordIdx] = block[wordIdx];
+    }
+}
+
+void PhiloxEngine::refill(quint32 *values, int count)
+{
+    // A hand never draws 2^32 blocks, an engine drawing for that long moves on to the stream of the next hand
+    for (int blockStart = 0; blockStart < count; blockStart += kBlockWords) {
+        generateBlock(_counter, _key, values + blockStart);
+        if (++_counter[0] == 0) {
+            ++_counter[1];
+        }
+    }
+}
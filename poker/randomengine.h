@@ -0,0 +1,239 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef RANDOMENGINE_H
+#define RANDOMENGINE_H
+
+#include <QRandomGenerator>
+#include <QSharedPointer>
+#include <QString>
+
+/**
+ * @brief RandomEngine is the source of randomness of the decks: a generator of uniform 32-bit values, produced in
+ *        bulk by the engine into a small buffer, and mapped to ranges without bias.
+ *
+ *        bounded() uses Lemire's multiply-shift: the high half of value * range is the result, and the (rare) values
+ *        whose low half would favour some results are rejected. The division computing the rejection threshold only
+ *        runs when a value may be rejected, so a draw is usually a buffer read and one multiplication.
+ *
+ *        The engines are:
+ *          - QT_GENERATOR: QRandomGenerator seeded from the system, as the decks always used
+ *          - XOSHIRO256:   xoshiro256**, very fast and reproducible from a 64-bit seed, for simulations (not secure)
+ *          - CHACHA20:     the ChaCha20 keystream (RFC 8439) keyed from the system, a CSPRNG for live play
+ *          - PHILOX:       Philox4x32-10, counter-based: independent streams derived from (seed, game, hand)
+ *
+ * @note  Engines are not thread-safe, every thread must draw from its own engine.
+ */
+class RandomEngine
+{
+public:
+    /**
+     * @brief EngineType selects one of the engines provided
+     */
+    enum EngineType {
+        QT_GENERATOR,
+        XOSHIRO256,
+        CHACHA20,
+        PHILOX
+    };
+
+    /**
+     * @brief      Creates an engine seeded (or keyed) from the system's entropy source
+     *
+     * @param[in]  type            engine to create
+     */
+    static QSharedPointer<RandomEngine> create(EngineType type);
+
+    /**
+     * @brief      Parses an engine name, as given on command lines ("qt", "xoshiro", "chacha20" or "philox")
+     *
+     * @exception  runtime_error will be raised if the name is not the one of an engine
+     */
+    static EngineType typeFromName(const QString &name);
+
+    virtual ~RandomEngine();
+
+    /**
+     * @brief      Next uniform 32-bit value
+     */
+    quint32 generate();
+
+    /**
+     * @brief      Uniform value in [0, range), without modulo bias
+     *
+     * @param[in]  range           number of possible values (must not be 0)
+     */
+    quint32 bounded(quint32 range);
+
+    /**
+     * @brief      Which engine this is
+     */
+    virtual EngineType type() const = 0;
+
+protected:
+    RandomEngine();
+
+    /**
+     * @brief      Produces the next values of the engine's stream
+     *
+     * @param[out] values          filled with count uniform 32-bit values
+     * @param[in]  count           number of values, always kBufferSize
+     */
+    virtual void refill(quint32 *values, int count) = 0;
+
+    /// Number of values produced by each refill (a multiple of the 16 words of a ChaCha20 block)
+    static const int kBufferSize = 64;
+
+private:
+    quint32 _buffer[kBufferSize];
+    int     _nextValue;    // Position of the next value to hand out, kBufferSize once the buffer is used up
+};
+
+/**
+ * @brief QRandomGenerator behind the RandomEngine interface
+ */
+class QtRandomEngine : public RandomEngine
+{
+public:
+    explicit QtRandomEngine(quint32 seed);
+    EngineType type() const;
+
+protected:
+    void refill(quint32 *values, int count);
+
+private:
+    QRandomGenerator _generator;
+};
+
+/**
+ * @brief xoshiro256** by Blackman and Vigna: 256 bits of state, 64-bit outputs (each gives two values)
+ */
+class Xoshiro256Engine : public RandomEngine
+{
+public:
+    /**
+     * @brief      Seeds the state by running splitmix64 from the seed (the same seed always gives the same stream)
+     */
+    explicit Xoshiro256Engine(quint64 seed);
+    EngineType type() const;
+
+protected:
+    void refill(quint32 *values, int count);
+
+private:
+    quint64 _state[4];
+};
+
+/**
+ * @brief ChaCha20 keystream (RFC 8439 block function with a 32-bit block counter and a 96-bit nonce), each block
+ *        giving 16 values. The nonce is bumped whenever the counter wraps, so the stream never repeats.
+ */
+class ChaCha20Engine : public RandomEngine
+{
+public:
+    /// Number of 32-bit words in a key, a nonce and a block
+    static const int kKeyWords   = 8;
+    static const int kNonceWords = 3;
+    static const int kBlockWords = 16;
+
+    /**
+     * @brief      Keys the engine explicitly, e.g. to replay or audit a stream
+     *
+     * @param[in]  key             256-bit key, as 8 little-endian words
+     * @param[in]  nonce           96-bit nonce, as 3 little-endian words
+     * @param[in]  counter         number of the first block
+     */
+    ChaCha20Engine(const quint32 *key, const quint32 *nonce, quint32 counter);
+    EngineType type() const;
+
+protected:
+    void refill(quint32 *values, int count);
+
+private:
+    quint32 _key[kKeyWords];
+    quint32 _nonce[kNonceWords];
+    quint32 _counter;
+};
+
+/**
+ * @brief Philox4x32-10 by Salmon et al. (Random123): a counter-based generator, each block of 4 values being a keyed
+ *        bijection of its position in the stream, so streams need no state beyond where they are.
+ *
+ *        The 64-bit key is a game seed and the 128-bit counter holds the block number, a hand index and a game number:
+ *        every (seed, game, hand) is an independent stream that any thread can rebuild and draw from, always getting
+ *        the same values. Recording the seed is enough to replay any game bit for bit.
+ */
+class PhiloxEngine : public RandomEngine
+{
+public:
+    /// Number of 32-bit words in a key and in a counter (and output) block
+    static const int kKeyWords   = 2;
+    static const int kBlockWords = 4;
+
+    /**
+     * @brief      Positions the engine at the start of the stream of a hand of a game
+     *
+     * @param[in]  seed            game seed (the key)
+     * @param[in]  gameNumber      number of the game played with the seed
+     * @param[in]  handIndex       hand of the game
+     */
+    PhiloxEngine(quint64 seed, quint64 gameNumber, quint32 handIndex);
+    EngineType type() const;
+
+    /**
+     * @brief      The Philox4x32-10 bijection
+     *
+     * @param[in]  counter         kBlockWords counter words
+     * @param[in]  key             kKeyWords key words
+     * @param[out] output          kBlockWords random words
+     */
+    static void generateBlock(const quint32 *counter, const quint32 *key, quint32 *output);
+
+protected:
+    void refill(quint32 *values, int count);
+
+private:
+    quint32 _key[kKeyWords];
+    quint32 _counter[kBlockWords];    // Block number, hand index, game number (low then high word)
+};
+
+inline quint32 RandomEngine::generate()
+{
+    if (_nextValue == kBufferSize) {
+        refill(_buffer, kBufferSize);
+        _nextValue = 0;
+    }
+    return _buffer[_nextValue++];
+}
+
+inline quint32 RandomEngine::bounded(quint32 range)
+{
+    quint64 product = static_cast<quint64>(generate()) * range;
+    quint32 low     = static_cast<quint32>(product);
+    if (low < range) {
+        // 2^32 mod range values of the low half must be rejected for all results to be equally likely
+        const quint32 threshold = (0u - range) % range;
+        while (low < threshold) {
+            product = static_cast<quint64>(generate()) * range;
+            low     = static_cast<quint32>(product);
+        }
+    }
+    return static_cast<quint32>(product >> 32);
+}
+
+#endif // RANDOMENGINE_H
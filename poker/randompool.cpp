@@ -0,0 +1,123 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "randompool.h"
+
+#include <QRunnable>
+#include <QThread>
+
+const quint32 RandomPool::kRingSize;
+
+namespace {
+
+// Values written to the ring at once by the service thread
+const quint32 kChunkSize = 64;
+
+}  // namespace
+
+/**
+ * @brief Fills the ring until the pool stops
+ */
+class RandomPool::ServiceTask : public QRunnable
+{
+public:
+    explicit ServiceTask(RandomPool &pool) : _pool(pool)
+    {
+    }
+
+    void run()
+    {
+        // Game play comes first, the ring has thousands of values to give before it runs dry
+        QThread *serviceThread = QThread::currentThread();
+        if (serviceThread) {
+            serviceThread->setPriority(QThread::IdlePriority);
+        }
+
+        while (!_pool._stopping.loadAcquire()) {
+            const quint32 produced = _pool._produced.loadAcquire();
+            if (produced - _pool._consumed.loadAcquire() <= kRingSize - kChunkSize) {
+                for (quint32 valueIdx = 0; valueIdx < kChunkSize; ++valueIdx) {
+                    _pool._ring[(produced + valueIdx) % kRingSize] = _pool._source->generate();
+                }
+                _pool._produced.storeRelease(produced + kChunkSize);
+            } else {
+                // The ring is full, the source keeps cycling all the same (like a terminal's RNG between games)
+                for (quint32 valueIdx = 0; valueIdx < kChunkSize; ++valueIdx) {
+                    _pool._source->generate();
+                }
+                QThread::yieldCurrentThread();
+            }
+        }
+    }
+
+private:
+    RandomPool &_pool;
+};
+
+RandomPool::RandomPool(EngineType sourceType, bool startService)
+    : _sourceType(sourceType),
+      _source    (RandomEngine::create(sourceType)),
+      _fallback  (RandomEngine::create(sourceType)),
+      _produced  (0),
+      _consumed  (0),
+      _underruns (0),
+      _stopping  (0)
+{
+    _service.setMaxThreadCount(1);
+    if (startService) {
+        _service.start(new ServiceTask(*this));
+    }
+}
+
+RandomPool::~RandomPool()
+{
+    _stopping.storeRelease(1);
+    _service.waitForDone();
+}
+
+RandomEngine::EngineType RandomPool::type() const
+{
+    return _sourceType;
+}
+
+quint32 RandomPool::nbUnderruns() const
+{
+    return _underruns.loadAcquire();
+}
+
+quint32 RandomPool::nbReady() const
+{
+    return _produced.loadAcquire() - _consumed.loadAcquire();
+}
+
+void RandomPool::refill(quint32 *values, int count)
+{
+    const quint32 consumed = _consumed.loadAcquire();
+    if (_produced.loadAcquire() - consumed < static_cast<quint32>(count)) {
+        _underruns.fetchAndAddRelaxed(1);
+        for (int valueIdx = 0; valueIdx < count; ++valueIdx) {
+            values[valueIdx] = _fallback->generate();
+        }
+        return;
+    }
+
+    for (int valueIdx = 0; valueIdx < count; ++valueIdx) {
+        values[valueIdx] = _ring[(consumed + valueIdx) % kRingSize];
+    }
+    _consumed.storeRelease(consumed + count);
+}
@@ -0,0 +1,90 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef RANDOMPOOL_H
+#define RANDOMPOOL_H
+
+#include "randomengine.h"
+
+#include <QAtomicInteger>
+#include <QThreadPool>
+
+/**
+ * @brief RandomPool is a RandomEngine whose values are produced ahead of time by a service thread, the way real
+ *        terminals keep their RNG cycling between games: drawing a card only reads values that are already there.
+ *
+ *        The service thread keeps a bounded ring of ready values full. The ring is lock-free with a single producer
+ *        (the service thread) and a single consumer (whoever draws from the pool, so a pool must only be drawn from by
+ *        one thread at a time, like any engine). While the ring is full the service thread keeps cycling the source
+ *        engine, the values it produces being dropped, so the values drawn depend on when they are drawn. It runs at
+ *        idle priority, only taking the CPU time nothing else wants.
+ *
+ *        If the ring runs dry, the values are generated on the spot by a fallback engine of the same type and the
+ *        underrun is counted (see nbUnderruns), so a draw never waits.
+ */
+class RandomPool : public RandomEngine
+{
+public:
+    /// Number of values the ring holds
+    static const quint32 kRingSize = 4096;
+
+    /**
+     * @brief      Creates a pool of values of an engine (seeded from the system) and starts its service thread
+     *
+     * @param[in]  sourceType      engine producing the values
+     * @param[in]  startService    false to leave the ring empty (for tests: every value then comes from the fallback)
+     */
+    explicit RandomPool(EngineType sourceType, bool startService = true);
+
+    /**
+     * @brief      Stops the service thread
+     */
+    ~RandomPool();
+
+    EngineType type() const;
+
+    /**
+     * @brief      Number of times the ring was found too empty to hand out values
+     */
+    quint32 nbUnderruns() const;
+
+    /**
+     * @brief      Number of values ready in the ring
+     */
+    quint32 nbReady() const;
+
+protected:
+    void refill(quint32 *values, int count);
+
+private:
+    Q_DISABLE_COPY(RandomPool)
+
+    class ServiceTask;
+
+    EngineType                   _sourceType;
+    QSharedPointer<RandomEngine> _source;       // Only used by the service thread
+    QSharedPointer<RandomEngine> _fallback;     // Only used by the consumer, on underruns
+    quint32                      _ring[kRingSize];
+    QAtomicInteger<quint32>      _produced;     // Values written to the ring so far (wrapping), by the service thread
+    QAtomicInteger<quint32>      _consumed;     // Values read from the ring so far (wrapping), by the consumer
+    QAtomicInteger<quint32>      _underruns;
+    QAtomicInt                   _stopping;
+    QThreadPool                  _service;
+};
+
+#endif // RANDOMPOOL_H
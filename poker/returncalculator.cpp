@@ -0,0 +1,247 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "returncalculator.h"
+
+#include "handcombinatorics.h"
+
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+namespace {
+
+// Cards left in the deck once a hand has been dealt
+const int     kNbRemaining   = PlayingCard::kNbCards - Hand::kCardsPerHand;
+
+// Number of deals a worker thread claims at once while computing the return of a game
+const int     kDealsPerClaim = 256;
+
+// Upper bound of (nbDrawn + 1) ^ nbHeld over all holds, see DrawContext::heldIndex
+const int     kMaxHeldCodes  = 32;
+
+/*
+ * Enumerating the draws of a hold
+ *
+ * The colex index of a final hand is the sum of C(card, position) over its cards sorted in increasing order (positions
+ * starting at 1). The draws are enumerated in increasing order, so the position of a drawn card is known up-front:
+ * 1 + the number of cards drawn before it (the loop depth) + the number of held cards below it. The contribution of
+ * each drawn card is therefore precomputed per loop depth.
+ *
+ * The position of a held card depends on how many drawn cards fall below it. Those counts (one digit per held card,
+ * each in [0, nbDrawn]) are accumulated as a mixed-radix "code" while drawing, which then indexes the precomputed
+ * contribution of all the held cards together.
+ */
+struct DrawContext {
+    const HoldSolver *solver;
+    quint32           drawnIndex[Hand::kCardsPerHand][kNbRemaining];    // [loop depth][remaining card]
+    quint32           codeStep[kNbRemaining];                           // [remaining card]
+    quint32           heldIndex[kMaxHeldCodes];                         // [code]
+};
+
+template <int kLeftToDraw>
+struct DrawSummer {
+    static quint64 sum(const DrawContext &context, int depth, int firstCard, quint32 drawnIndex, quint32 heldCode)
+    {
+        quint64 totalCredits = 0;
+        for (int cardIdx = firstCard; cardIdx <= kNbRemaining - kLeftToDraw; ++cardIdx) {
+            totalCredits += DrawSummer<kLeftToDraw - 1>::sum(context,
+                                                              depth + 1,
+                                                              cardIdx + 1,
+                                                              drawnIndex + context.drawnIndex[depth][cardIdx],
+                                                              heldCode + context.codeStep[cardIdx]);
+        }
+        return totalCredits;
+    }
+};
+
+template <>
+struct DrawSummer<0> {
+    static quint64 sum(const DrawContext &context, int, int, quint32 drawnIndex, quint32 heldCode)
+    {
+        return context.solver->payout(drawnIndex + context.heldIndex[heldCode]);
+    }
+};
+
+quint64 sumAllDraws(const DrawContext &context, quint8 nbToDraw)
+{
+    switch (nbToDraw) {
+    case 0:
+        return DrawSummer<0>::sum(context, 0, 0, 0, 0);
+    case 1:
+        return DrawSummer<1>::sum(context, 0, 0, 0, 0);
+    case 2:
+        return DrawSummer<2>::sum(context, 0, 0, 0, 0);
+    case 3:
+        return DrawSummer<3>::sum(context, 0, 0, 0, 0);
+    case 4:
+        return DrawSummer<4>::sum(context, 0, 0, 0, 0);
+    default:
+        return DrawSummer<5>::sum(context, 0, 0, 0, 0);
+    }
+}
+
+/**
+ * @brief Solves deals of the canonical hand list until there are none left, storing the best EV of each
+ */
+class ReturnWorker : public QRunnable
+{
+public:
+    ReturnWorker(const HoldSolver                               &solver,
+                 const QVector<HandCombinatorics::CanonicalHand> &deals,
+                 double                                          *bestValues,
+                 QAtomicInt                                      &nextDeal)
+        : _solver(solver), _deals(deals), _bestValues(bestValues), _nextDeal(nextDeal)
+    {
+    }
+
+    void run()
+    {
+        for (;;) {
+            const int firstDeal = _nextDeal.fetchAndAddRelaxed(kDealsPerClaim);
+            if (firstDeal >= _deals.size()) {
+                return;
+            }
+            const int lastDeal = qMin(firstDeal + kDealsPerClaim, _deals.size());
+            for (int dealIdx = firstDeal; dealIdx < lastDeal; ++dealIdx) {
+                const HoldSolver::HoldValues holds = _solver.solve(_deals[dealIdx].cardSet);
+                _bestValues[dealIdx] = holds.expectedValue[holds.bestHold];
+            }
+        }
+    }
+
+private:
+    const HoldSolver                                &_solver;
+    const QVector<HandCombinatorics::CanonicalHand> &_deals;
+    double                                          *_bestValues;
+    QAtomicInt                                      &_nextDeal;
+};
+
+}  // namespace
+
+ReturnCalculator::ReturnCalculator(PokerGame *game, quint32 nbCreditsBet) : _solver(game, nbCreditsBet)
+{
+}
+
+ReturnCalculator::ReturnCalculator(const DrawOutcomes &outcomes, const PokerGame &game, quint32 nbCreditsBet)
+    : _solver(outcomes, game, nbCreditsBet)
+{
+}
+
+ReturnCalculator::HoldValues ReturnCalculator::solveDealByEnumeration(quint64 dealtCards) const
+{
+    // The dealt cards and the rest of the deck, both in increasing order
+    quint8 dealt[Hand::kCardsPerHand];
+    quint8 remaining[kNbRemaining];
+    quint8 nbDealt     = 0;
+    quint8 nbRemaining = 0;
+    for (quint8 cardIdx = 0; cardIdx < PlayingCard::kNbCards; ++cardIdx) {
+        if (dealtCards & (Q_UINT64_C(1) << cardIdx)) {
+            dealt[nbDealt++] = cardIdx;
+        } else {
+            remaining[nbRemaining++] = cardIdx;
+        }
+    }
+    if (nbDealt != Hand::kCardsPerHand) {
+        throw std::runtime_error("A deal must have exactly 5 cards");
+    }
+
+    DrawContext context;
+    context.solver = &_solver;
+
+    HoldValues holdValues;
+    holdValues.bestHold = 0;
+    for (quint8 holdMask = 0; holdMask < HoldSolver::kNbHolds; ++holdMask) {
+        quint8 held[Hand::kCardsPerHand];
+        quint8 nbHeld = 0;
+        for (quint8 dealtIdx = 0; dealtIdx < Hand::kCardsPerHand; ++dealtIdx) {
+            if (holdMask & (1 << dealtIdx)) {
+                held[nbHeld++] = dealt[dealtIdx];
+            }
+        }
+        const quint8 nbToDraw = Hand::kCardsPerHand - nbHeld;
+        const quint32 radix   = nbToDraw + 1;
+
+        // Held cards: the code digit i counts the drawn cards below the i-th held card
+        quint32 digitWeight[Hand::kCardsPerHand + 1];
+        quint32 nbCodes = 1;
+        for (quint8 heldIdx = 0; heldIdx < nbHeld; ++heldIdx) {
+            digitWeight[heldIdx] = nbCodes;
+            nbCodes *= radix;
+        }
+        for (quint32 code = 0; code < nbCodes; ++code) {
+            quint32 index = 0;
+            quint32 digits = code;
+            for (quint8 heldIdx = 0; heldIdx < nbHeld; ++heldIdx) {
+                index += HandCombinatorics::binomial(held[heldIdx], heldIdx + 1 + digits % radix);
+                digits /= radix;
+            }
+            context.heldIndex[code] = index;
+        }
+
+        // Remaining cards: a drawn card moves up every held card above it by one position
+        quint8 nbHeldBelow = 0;
+        for (int cardIdx = 0; cardIdx < kNbRemaining; ++cardIdx) {
+            while (nbHeldBelow < nbHeld && held[nbHeldBelow] < remaining[cardIdx]) {
+                ++nbHeldBelow;
+            }
+            quint32 step = 0;
+            for (quint8 heldIdx = nbHeldBelow; heldIdx < nbHeld; ++heldIdx) {
+                step += digitWeight[heldIdx];
+            }
+            context.codeStep[cardIdx] = step;
+            for (quint8 depth = 0; depth < nbToDraw; ++depth) {
+                context.drawnIndex[depth][cardIdx] = HandCombinatorics::binomial(remaining[cardIdx],
+                                                                                 depth + nbHeldBelow + 1);
+            }
+        }
+
+        const quint64 totalCredits = sumAllDraws(context, nbToDraw);
+        holdValues.expectedValue[holdMask] = static_cast<double>(totalCredits) /
+                                             HandCombinatorics::binomial(kNbRemaining, nbToDraw);
+        if (holdValues.expectedValue[holdMask] > holdValues.expectedValue[holdValues.bestHold]) {
+            holdValues.bestHold = holdMask;
+        }
+    }
+    return holdValues;
+}
+
+double ReturnCalculator::computeReturn(int nbThreads) const
+{
+    if (nbThreads <= 0) {
+        nbThreads = QThread::idealThreadCount();
+    }
+
+    // Only one deal per suit-isomorphic class needs solving, it then counts as many times as the class has deals
+    const QVector<HandCombinatorics::CanonicalHand> deals = HandCombinatorics::canonicalHands();
+    QVector<double> bestValues(deals.size());
+    QAtomicInt      nextDeal(0);
+
+    QThreadPool workers;
+    workers.setMaxThreadCount(nbThreads);
+    for (int workerIdx = 0; workerIdx < nbThreads; ++workerIdx) {
+        workers.start(new ReturnWorker(_solver, deals, bestValues.data(), nextDeal));
+    }
+    workers.waitForDone();
+
+    double totalValue = 0.0;
+    for (int dealIdx = 0; dealIdx < deals.size(); ++dealIdx) {
+        totalValue += deals[dealIdx].weight * bestValues[dealIdx];
+    }
+    return totalValue / HandCombinatorics::kNbFiveCardHands / _solver.creditsBet();
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RETURNCALCULATOR_H
+#define RETURNCALCULATOR_H
+
+#include "holdsolver.h"
+
+/**
+ * @brief ReturnCalculator computes the exact theoretical return (RTP) of a PokerGame paytable, assuming the player
+ *        always makes the hold with the highest expected value.
+ *
+ *        The return of the game is the weighted average of the best hold of each suit-isomorphic deal, the holds being
+ *        valued by a HoldSolver. The original draw-by-draw enumeration is kept as solveDealByEnumeration() to validate
+ *        the solver against.
+ */
+class ReturnCalculator
+{
+public:
+    typedef HoldSolver::HoldValues HoldValues;
+
+    /**
+     * @brief      Prepares the hold solver of the game for the requested bet
+     *
+     * @param[in]  game           game whose paytable is analyzed (only used during construction)
+     * @param[in]  nbCreditsBet   number of credits bet on each hand (1 to 5)
+     *
+     * @exception  runtime_error will be raised if the bet is not valid for the game
+     */
+    ReturnCalculator(PokerGame *game, quint32 nbCreditsBet);
+
+    /**
+     * @brief      Prepares the hold solver of a paytable from draw outcomes counted beforehand (no hand is scored)
+     *
+     * @param[in]  outcomes       draw outcomes counted for a game with the same paytable rows
+     * @param[in]  game           game whose payouts are analyzed (only used during construction)
+     * @param[in]  nbCreditsBet   number of credits bet on each hand (1 to 5)
+     *
+     * @exception  runtime_error will be raised if the bet is not valid or the paytable rows were not the ones counted
+     */
+    ReturnCalculator(const DrawOutcomes &outcomes, const PokerGame &game, quint32 nbCreditsBet);
+
+    /**
+     * @brief      Computes the expected value of all 32 holds of a deal by enumerating every possible draw (slow, this
+     *             takes milliseconds per deal rather than microseconds, see HoldSolver::solve for the fast version)
+     *
+     * @param[in]  dealtCards     5-card set (see Hand::cardSet())
+     *
+     * @return     the value of each hold (bits in card index order) and the best one (the first one found on ties)
+     */
+    HoldValues solveDealByEnumeration(quint64 dealtCards) const;
+
+    /**
+     * @brief      Computes the return of the game under optimal play over all 2,598,960 possible deals
+     *
+     * @param[in]  nbThreads      number of threads sharing the work (defaults to one per core)
+     *
+     * @return     expected credits won per credit bet (e.g. 0.995 for a 99.5% game)
+     */
+    double computeReturn(int nbThreads = 0) const;
+
+    /**
+     * @brief      The solver used to value holds
+     */
+    const HoldSolver &solver() const;
+
+private:
+    HoldSolver _solver;
+};
+
+inline const HoldSolver &ReturnCalculator::solver() const {return _solver;}
+
+#endif // RETURNCALCULATOR_H
@@ -0,0 +1,283 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "strategytable.h"
+
+#include "handcombinatorics.h"
+
+#include <QVector>
+
+#include <algorithm>
+#include <cstring>
+
+struct StrategyTable::Header {
+    char    magic[8];
+    quint32 version;
+    quint32 nbCreditsBet;
+    quint64 payTableHash;
+    quint32 nbDeals;
+    quint32 nbSlots;
+    quint32 nbBuckets;
+    quint32 reserved;
+};
+
+struct StrategyTable::Slot {
+    quint64 canonicalDeal;
+    float   expectedValue[HoldSolver::kNbHolds];
+    quint8  bestHold;
+    quint8  reserved[7];
+};
+
+const quint32 StrategyTable::kFileVersion;
+
+namespace {
+
+const char    kMagic[8]        = {'V', 'P', 'S', 'T', 'R', 'A', 'T', '\0'};
+
+// Deals per bucket on average, and extra slots (in percent): more of either makes the displacement search shorter
+const quint32 kDealsPerBucket  = 4;
+const quint32 kSlotSlackPct    = 1;
+
+// A bucket whose deals still collide after this many displacements means the hash is broken
+const quint32 kMaxDisplacement = 1 << 24;
+
+const quint64 kStepSeed        = Q_UINT64_C(0x9E3779B97F4A7C15);
+
+// splitmix64 finalizer: every bit of the deal affects every bit of the hash
+quint64 mixBits(quint64 value)
+{
+    value = (value ^ (value >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+    value = (value ^ (value >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+    return value ^ (value >> 31);
+}
+
+/**
+ * @brief Bucket of a deal and the slots its displacements point to: first + displacement * step (the number of slots
+ *        is prime, so any step goes through every slot)
+ */
+struct DealHash {
+    quint32 bucket;
+    quint32 first;
+    quint32 step;
+
+    DealHash(quint64 canonicalDeal, quint32 nbBuckets, quint32 nbSlots)
+    {
+        const quint64 bucketAndFirst = mixBits(canonicalDeal);
+        bucket = static_cast<quint32>((bucketAndFirst >> 32) % nbBuckets);
+        first  = static_cast<quint32>((bucketAndFirst & 0xFFFFFFFF) % nbSlots);
+        step   = static_cast<quint32>(1 + mixBits(canonicalDeal ^ kStepSeed) % (nbSlots - 1));
+    }
+
+    quint32 slot(quint32 displacement, quint32 nbSlots) const
+    {
+        return static_cast<quint32>((first + static_cast<quint64>(displacement) * step) % nbSlots);
+    }
+};
+
+quint32 nextPrime(quint32 number)
+{
+    for (;; ++number) {
+        bool isPrime = (number > 1);
+        for (quint32 divisor = 2; isPrime && divisor * divisor <= number; ++divisor) {
+            isPrime = (number % divisor != 0);
+        }
+        if (isPrime) {
+            return number;
+        }
+    }
+}
+
+// Offset of the slots in the file: they follow the displacements, 8-byte aligned (the mapping is page-aligned)
+qint64 slotsOffset(qint64 headerSize, quint32 nbBuckets)
+{
+    const qint64 displacementsEnd = headerSize + static_cast<qint64>(sizeof(quint32)) * nbBuckets;
+    return (displacementsEnd + 7) & ~Q_INT64_C(7);
+}
+
+}  // namespace
+
+StrategyTable::StrategyTable(const QString &fileName, const PokerGame &game, quint32 nbCreditsBet)
+    : _file(fileName),
+      _mapping(nullptr)
+{
+    if (!_file.open(QIODevice::ReadOnly)) {
+        throw std::runtime_error("Cannot open the strategy file");
+    }
+    if (_file.size() < static_cast<qint64>(sizeof(Header))) {
+        throw std::runtime_error("Not a strategy file");
+    }
+    _mapping = _file.map(0, _file.size());
+    if (_mapping == nullptr) {
+        throw std::runtime_error("Cannot map the strategy file");
+    }
+
+    Header header;
+    std::memcpy(&header, _mapping, sizeof(Header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kFileVersion) {
+        throw std::runtime_error("Not a strategy file (or one from another version)");
+    }
+    if (header.payTableHash != game.payTableHash() || header.nbCreditsBet != nbCreditsBet) {
+        throw std::runtime_error("The strategy file was computed for another paytable or bet");
+    }
+    const qint64 slotsStart = slotsOffset(sizeof(Header), header.nbBuckets);
+    if (header.nbSlots < 2 || header.nbBuckets == 0 ||
+        _file.size() != slotsStart + static_cast<qint64>(sizeof(Slot)) * header.nbSlots) {
+        throw std::runtime_error("The strategy file is damaged");
+    }
+
+    _nbSlots       = header.nbSlots;
+    _nbBuckets     = header.nbBuckets;
+    _displacements = reinterpret_cast<const quint32 *>(_mapping + sizeof(Header));
+    _slots         = reinterpret_cast<const Slot *>(_mapping + slotsStart);
+}
+
+StrategyTable::~StrategyTable()
+{
+    if (_mapping != nullptr) {
+        _file.unmap(_mapping);
+    }
+}
+
+HoldSolver::HoldValues StrategyTable::solve(quint64 canonicalDeal) const
+{
+    const DealHash dealHash(canonicalDeal, _nbBuckets, _nbSlots);
+    const Slot    &slot = _slots[dealHash.slot(_displacements[dealHash.bucket], _nbSlots)];
+    if (slot.canonicalDeal != canonicalDeal) {
+        throw std::runtime_error("Deal not found in the strategy table");
+    }
+
+    HoldSolver::HoldValues holdValues;
+    for (quint8 hold = 0; hold < HoldSolver::kNbHolds; ++hold) {
+        holdValues.expectedValue[hold] = slot.expectedValue[hold];
+    }
+    holdValues.bestHold = slot.bestHold;
+    return holdValues;
+}
+
+HoldSolver::HoldValues StrategyTable::solve(const Hand &dealtHand) const
+{
+    quint8        cardBits[Hand::kCardsPerHand];
+    const quint64 canonicalDeal = HandCombinatorics::canonicalDeal(dealtHand, cardBits);
+    return HoldSolver::byHandPosition(solve(canonicalDeal), cardBits);
+}
+
+QString StrategyTable::fileName(const PokerGame &game, quint32 nbCreditsBet)
+{
+    QString baseName = game.gameName().toLower();
+    baseName.remove(' ');
+    return baseName + "_bet" + QString::number(nbCreditsBet) + ".vpstrat";
+}
+
+void StrategyTable::write(const QString &fileName, const HoldSolver &solver, quint64 payTableHash)
+{
+    // Every canonical deal is stored under its key (the representatives are just one deal of each class)
+    const QVector<HandCombinatorics::CanonicalHand> classes = HandCombinatorics::canonicalHands();
+    QVector<quint64> deals;
+    deals.reserve(classes.size());
+    for (const HandCombinatorics::CanonicalHand &dealClass : classes) {
+        deals.push_back(HandCombinatorics::canonicalKey(dealClass.cardSet));
+    }
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version      = kFileVersion;
+    header.nbCreditsBet = solver.creditsBet();
+    header.payTableHash = payTableHash;
+    header.nbDeals      = static_cast<quint32>(deals.size());
+    header.nbSlots      = nextPrime(header.nbDeals + header.nbDeals * kSlotSlackPct / 100);
+    header.nbBuckets    = (header.nbDeals + kDealsPerBucket - 1) / kDealsPerBucket;
+    header.reserved     = 0;
+
+    // Place the biggest buckets first, each at the first displacement where all its deals land on free slots
+    QVector<QVector<quint32>> dealsOfBucket(header.nbBuckets);
+    for (quint32 dealIdx = 0; dealIdx < header.nbDeals; ++dealIdx) {
+        dealsOfBucket[DealHash(deals[dealIdx], header.nbBuckets, header.nbSlots).bucket].push_back(dealIdx);
+    }
+    QVector<quint32> bucketOrder(header.nbBuckets);
+    for (quint32 bucket = 0; bucket < header.nbBuckets; ++bucket) {
+        bucketOrder[bucket] = bucket;
+    }
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&dealsOfBucket](quint32 lhs, quint32 rhs) {
+        return dealsOfBucket[lhs].size() > dealsOfBucket[rhs].size();
+    });
+
+    QVector<quint32> displacements(header.nbBuckets, 0);
+    QVector<qint32>  dealInSlot(header.nbSlots, -1);
+    QVector<quint32> candidateSlots;
+    for (quint32 bucket : bucketOrder) {
+        const QVector<quint32> &bucketDeals = dealsOfBucket[bucket];
+        if (bucketDeals.isEmpty()) {
+            break;
+        }
+
+        quint32 displacement = 0;
+        for (; displacement < kMaxDisplacement; ++displacement) {
+            candidateSlots.clear();
+            for (quint32 dealIdx : bucketDeals) {
+                const quint32 slot = DealHash(deals[dealIdx], header.nbBuckets, header.nbSlots).slot(displacement,
+                                                                                                      header.nbSlots);
+                if (dealInSlot[slot] != -1 || candidateSlots.contains(slot)) {
+                    break;
+                }
+                candidateSlots.push_back(slot);
+            }
+            if (candidateSlots.size() == bucketDeals.size()) {
+                break;
+            }
+        }
+        if (displacement == kMaxDisplacement) {
+            throw std::runtime_error("Could not build the strategy table hash");
+        }
+
+        displacements[bucket] = displacement;
+        for (int dealNb = 0; dealNb < bucketDeals.size(); ++dealNb) {
+            dealInSlot[candidateSlots[dealNb]] = static_cast<qint32>(bucketDeals[dealNb]);
+        }
+    }
+
+    // Then solve the deals into their slots
+    QVector<Slot> tableSlots(header.nbSlots);
+    std::memset(tableSlots.data(), 0, sizeof(Slot) * header.nbSlots);
+    for (quint32 slotIdx = 0; slotIdx < header.nbSlots; ++slotIdx) {
+        if (dealInSlot[slotIdx] == -1) {
+            continue;
+        }
+        Slot &slot = tableSlots[slotIdx];
+        slot.canonicalDeal = deals[dealInSlot[slotIdx]];
+        const HoldSolver::HoldValues holdValues = solver.solve(slot.canonicalDeal);
+        for (quint8 hold = 0; hold < HoldSolver::kNbHolds; ++hold) {
+            slot.expectedValue[hold] = static_cast<float>(holdValues.expectedValue[hold]);
+        }
+        slot.bestHold = holdValues.bestHold;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        throw std::runtime_error("Cannot write the strategy file");
+    }
+    const qint64 slotsStart = slotsOffset(sizeof(Header), header.nbBuckets);
+    const qint64 padding    = slotsStart - static_cast<qint64>(sizeof(Header) + sizeof(quint32) * header.nbBuckets);
+    const char   zeros[8]   = {0};
+    const qint64 slotsSize  = static_cast<qint64>(sizeof(Slot)) * header.nbSlots;
+    const qint64 dispSize   = static_cast<qint64>(sizeof(quint32)) * header.nbBuckets;
+    if (file.write(reinterpret_cast<const char *>(&header), sizeof(Header)) != sizeof(Header) ||
+        file.write(reinterpret_cast<const char *>(displacements.constData()), dispSize) != dispSize ||
+        file.write(zeros, padding) != padding ||
+        file.write(reinterpret_cast<const char *>(tableSlots.constData()), slotsSize) != slotsSize) {
+        throw std::runtime_error("Cannot write the strategy file");
+    }
+}
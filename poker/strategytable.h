@@ -0,0 +1,107 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STRATEGYTABLE_H
+#define STRATEGYTABLE_H
+
+#include "holdsolver.h"
+
+#include <QFile>
+#include <QString>
+
+/**
+ * @brief StrategyTable reads a precomputed strategy file: the value of every hold of the 134,459 canonical deals of a
+ *        game for one bet, written offline (see write() and the pokerrtp tool) for boards too slow to build a
+ *        HoldSolver at run time.
+ *
+ *        The file is mapped into memory rather than parsed, and deals are found through a perfect hash (hash and
+ *        displace: the deal picks a bucket, the displacement stored for the bucket picks the slot), so opening a table
+ *        is instant and a lookup touches two pages of the file. The header holds the bet and the
+ *        PokerGame::payTableHash() the file was computed with, so a strategy is never used with another paytable.
+ *
+ *        Layout (native byte order):  Header | displacement of each bucket (quint32) | padding to 8 bytes | slots
+ */
+class StrategyTable
+{
+public:
+    /// Version of the file layout, bumped on any incompatible change
+    static const quint32 kFileVersion = 1;
+
+    /**
+     * @brief      Maps a strategy file and checks it was computed for the paytable and bet of the game
+     *
+     * @param[in]  fileName       strategy file, see write()
+     * @param[in]  game           game the strategy will be used with
+     * @param[in]  nbCreditsBet   number of credits bet on each hand (1 to 5)
+     *
+     * @exception  runtime_error will be raised if the file cannot be mapped or is not a strategy for the game and bet
+     */
+    StrategyTable(const QString &fileName, const PokerGame &game, quint32 nbCreditsBet);
+
+    ~StrategyTable();
+
+    /**
+     * @brief      Looks up the value of all 32 holds of a canonical deal
+     *
+     * @param[in]  canonicalDeal  canonical key of the deal (see HandCombinatorics::canonicalKey)
+     *
+     * @exception  runtime_error will be raised if the deal is not in the table (not a canonical 5-card deal)
+     *
+     * @return     the value of each hold (bits in card index order of the canonical deal) and the best one
+     */
+    HoldSolver::HoldValues solve(quint64 canonicalDeal) const;
+
+    /**
+     * @brief      Looks up the value of all 32 holds of a dealt hand
+     *
+     * @param[in]  dealtHand      hand holding 5 real cards
+     *
+     * @return     the value of each hold (bits in hand position order) and the best one
+     */
+    HoldSolver::HoldValues solve(const Hand &dealtHand) const;
+
+    /**
+     * @brief      Usual name of the strategy file of a game and bet, e.g. "jacksorbetter_bet5.vpstrat"
+     */
+    static QString fileName(const PokerGame &game, quint32 nbCreditsBet);
+
+    /**
+     * @brief      Solves every canonical deal and writes the strategy file
+     *
+     * @param[in]  fileName       file to (over)write
+     * @param[in]  solver         solver of the game and bet the strategy is for
+     * @param[in]  payTableHash   PokerGame::payTableHash() of the game the solver was built for
+     *
+     * @exception  runtime_error will be raised if the file cannot be written
+     */
+    static void write(const QString &fileName, const HoldSolver &solver, quint64 payTableHash);
+
+private:
+    Q_DISABLE_COPY(StrategyTable)
+
+    struct Header;
+    struct Slot;
+
+    QFile          _file;
+    uchar         *_mapping;
+    quint32        _nbSlots;
+    quint32        _nbBuckets;
+    const quint32 *_displacements;   // Displacement of each bucket
+    const Slot    *_slots;           // Hold values of each slot, unused slots have a 0 deal
+};
+
+#endif // STRATEGYTABLE_H
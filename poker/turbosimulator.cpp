@@ -0,0 +1,222 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "turbosimulator.h"
+
+#include "deck.h"
+#include "deckview.h"
+
+#include <QAtomicInteger>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+
+const quint64 TurboSimulator::kGamesPerBlock;
+
+namespace {
+
+// Odd constant spreading the block numbers over the seeds of the block engines (xoshiro256** seeds its state with
+// splitmix64, whose own increment must be avoided: consecutive blocks would then draw shifted copies of one stream)
+const quint64 kBlockSeedStep = Q_UINT64_C(0xD1B54A32D192ED03);
+
+}  // namespace
+
+/**
+ * @brief Claims blocks of games until there are none left, adding what they won to the worker's own totals
+ */
+class TurboSimulator::BlockWorker : public QRunnable
+{
+public:
+    BlockWorker(const TurboSimulator    &simulator,
+                quint64                  nbGames,
+                const HoldStrategy      &strategy,
+                quint64                  seed,
+                QAtomicInteger<quint64> &nextBlock,
+                Results                 &results)
+        : _simulator(simulator), _nbGames(nbGames), _strategy(strategy), _seed(seed), _nextBlock(nextBlock),
+          _results(results)
+    {
+    }
+
+    void run()
+    {
+        for (;;) {
+            const quint64 firstGame = _nextBlock.fetchAndAddRelaxed(1) * kGamesPerBlock;
+            if (firstGame >= _nbGames) {
+                return;
+            }
+            _simulator.playBlock(firstGame, qMin(kGamesPerBlock, _nbGames - firstGame), _strategy, _seed, _results);
+        }
+    }
+
+private:
+    const TurboSimulator    &_simulator;
+    quint64                  _nbGames;
+    const HoldStrategy      &_strategy;
+    quint64                  _seed;
+    QAtomicInteger<quint64> &_nextBlock;
+    Results                 &_results;
+};
+
+HoldStrategy::~HoldStrategy()
+{
+}
+
+FixedHoldStrategy::FixedHoldStrategy(quint8 holdMask) : _holdMask(holdMask)
+{
+}
+
+quint8 FixedHoldStrategy::chooseHold(const Hand &dealtHand) const
+{
+    Q_UNUSED(dealtHand);
+    return _holdMask;
+}
+
+OptimalHoldStrategy::OptimalHoldStrategy(const HoldSolver &solver) : _solver(solver)
+{
+}
+
+quint8 OptimalHoldStrategy::chooseHold(const Hand &dealtHand) const
+{
+    return _solver.solve(dealtHand).bestHold;
+}
+
+double TurboSimulator::Results::gameReturn() const
+{
+    return creditsBet == 0 ? 0.0 : static_cast<double>(creditsWon) / creditsBet;
+}
+
+TurboSimulator::TurboSimulator(PokerGame *game, quint32 nbCreditsBet, quint32 nbHands)
+    : _game        (game),
+      _nbCreditsBet(nbCreditsBet),
+      _nbHands     (nbHands)
+{
+    if (_nbHands == 0) {
+        throw std::runtime_error("A game must play at least one hand");
+    }
+
+    // This also validates the bet
+    QVector<QPair<const QString, int>> payTable;
+    _game->currentPayTable(_nbCreditsBet, payTable);
+    for (const QPair<const QString, int> &row : payTable) {
+        _creditsByRow.push_back(static_cast<quint32>(row.second));
+    }
+}
+
+TurboSimulator::Results TurboSimulator::run(quint64 nbGames, const HoldStrategy &strategy, quint64 seed,
+                                            int nbThreads) const
+{
+    if (nbThreads <= 0) {
+        nbThreads = QThread::idealThreadCount();
+    }
+
+    // Every worker adds up its own totals, they are only merged once all the games are played
+    Results noGames;
+    noGames.nbGames    = 0;
+    noGames.nbHands    = 0;
+    noGames.creditsBet = 0;
+    noGames.creditsWon = 0;
+    noGames.handsByRow.fill(0, _creditsByRow.size());
+    QVector<Results>        workerResults(nbThreads, noGames);
+    QAtomicInteger<quint64> nextBlock(0);
+
+    QThreadPool workers;
+    workers.setMaxThreadCount(nbThreads);
+    for (int workerIdx = 0; workerIdx < nbThreads; ++workerIdx) {
+        workers.start(new BlockWorker(*this, nbGames, strategy, seed, nextBlock, workerResults[workerIdx]));
+    }
+    workers.waitForDone();
+
+    Results results = noGames;
+    for (const Results &worker : workerResults) {
+        results.nbGames    += worker.nbGames;
+        results.nbHands    += worker.nbHands;
+        results.creditsBet += worker.creditsBet;
+        results.creditsWon += worker.creditsWon;
+        for (int row = 0; row < results.handsByRow.size(); ++row) {
+            results.handsByRow[row] += worker.handsByRow[row];
+        }
+    }
+    return results;
+}
+
+void TurboSimulator::writeHistogram(const Results &results, QTextStream &out) const
+{
+    out << QString("%1 %2 %3 %4\n").arg("Hand", -20).arg("Hands", 16).arg("1 in", 12).arg("Return", 10);
+    for (int row = 0; row < results.handsByRow.size(); ++row) {
+        const QString handName = _game->handString(static_cast<quint8>(row));
+        const quint64 nbHands  = results.handsByRow[row];
+        const double  share    = results.creditsBet == 0 ? 0.0 : static_cast<double>(nbHands) * _creditsByRow[row] /
+                                                                   results.creditsBet;
+        out << QString("%1 %2 %3 %4%\n").arg(handName.isEmpty() ? QString("Nothing") : handName, -20)
+                                         .arg(nbHands, 16)
+                                         .arg(nbHands == 0 ? QString("-") :
+                                              QString::number(static_cast<double>(results.nbHands) / nbHands, 'f', 1),
+                                              12)
+                                         .arg(QString::number(share * 100.0, 'f', 4), 9);
+    }
+    out << results.nbGames << " game(s) of " << _nbHands << " hand(s), " << results.creditsBet << " credit(s) bet, "
+        << results.creditsWon << " won: return " << QString::number(results.gameReturn() * 100.0, 'f', 4) << "%\n";
+}
+
+void TurboSimulator::playBlock(quint64 firstGame, quint64 nbGames, const HoldStrategy &strategy, quint64 seed,
+                               Results &results) const
+{
+    // The engine of a block only depends on the seed and the block, whichever thread plays it
+    QSharedPointer<RandomEngine>   engine(new Xoshiro256Engine(seed ^ (firstGame / kGamesPerBlock * kBlockSeedStep)));
+    Deck                           deck(Deck::FULL_FRENCH, engine);
+    QVector<Hand>                  hands(static_cast<int>(_nbHands));
+    QVector<PokerGame::HandResult> handResults(static_cast<int>(_nbHands));
+
+    for (quint64 gameIdx = 0; gameIdx < nbGames; ++gameIdx) {
+        deck.reset();
+        deck.shuffle();
+        Hand dealtHand;
+        for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+            dealtHand.addCard(deck.drawCard());
+        }
+        const quint8 holdMask  = strategy.chooseHold(dealtHand);
+        quint64      heldCards = 0;
+        for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+            if (holdMask & (1 << cardIdx)) {
+                heldCards |= dealtHand.cardAt(cardIdx).cardBit();
+            }
+        }
+
+        // As in the orchestrator, the first hand draws from what is left of the deck, and every other hand from its
+        // own copy of the full deck without the held cards. The hands are rebuilt card by card, as a secondary hand
+        // may draw a dealt card that was not held.
+        for (int handIdx = 0; handIdx < hands.size(); ++handIdx) {
+            Hand     &hand = hands[handIdx];
+            DeckView  handDeck(handIdx == 0 ? deck.availableCards() : DeckView::kFullDeck & ~heldCards);
+            hand.reset();
+            for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+                hand.addCard((holdMask & (1 << cardIdx)) ? dealtHand.cardAt(cardIdx) : handDeck.drawCard(*engine));
+            }
+        }
+        _game->evaluateHands(hands.constData(), hands.size(), _nbCreditsBet, handResults.data());
+
+        for (const PokerGame::HandResult &handResult : handResults) {
+            ++results.handsByRow[handResult.payoutIdx];
+            results.creditsWon += handResult.creditsWon;
+        }
+    }
+
+    results.nbGames    += nbGames;
+    results.nbHands    += nbGames * _nbHands;
+    results.creditsBet += nbGames * _nbHands * _nbCreditsBet;
+}
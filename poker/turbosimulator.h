@@ -0,0 +1,164 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TURBOSIMULATOR_H
+#define TURBOSIMULATOR_H
+
+#include "holdsolver.h"
+
+#include <QTextStream>
+#include <QVector>
+
+/**
+ * @brief HoldStrategy picks the cards held on a deal. Simulations can plug any strategy, it only has to be
+ *        thread-safe since every simulation thread asks the same strategy.
+ */
+class HoldStrategy
+{
+public:
+    virtual ~HoldStrategy();
+
+    /**
+     * @brief      Picks the cards to hold
+     *
+     * @param[in]  dealtHand      hand holding the 5 dealt cards
+     *
+     * @return     cards to hold, bit i is the card at position i (the layout of Hand::holdMask())
+     */
+    virtual quint8 chooseHold(const Hand &dealtHand) const = 0;
+};
+
+/**
+ * @brief Always holds the same positions (e.g. Hand::kAllHeld to score the deals as they are)
+ */
+class FixedHoldStrategy : public HoldStrategy
+{
+public:
+    explicit FixedHoldStrategy(quint8 holdMask);
+    quint8 chooseHold(const Hand &dealtHand) const;
+
+private:
+    quint8 _holdMask;
+};
+
+/**
+ * @brief Holds the cards with the highest expected value, as valued by a HoldSolver
+ */
+class OptimalHoldStrategy : public HoldStrategy
+{
+public:
+    /**
+     * @param[in]  solver         solver of the game and bet simulated, it must outlive the strategy
+     */
+    explicit OptimalHoldStrategy(const HoldSolver &solver);
+    quint8 chooseHold(const Hand &dealtHand) const;
+
+private:
+    const HoldSolver &_solver;
+};
+
+/**
+ * @brief TurboSimulator plays complete games (deal, hold, draw and score) as fast as the cards can be scored, to soak
+ *        test the game logic and measure paytable returns empirically.
+ *
+ *        A game is played as GameOrchestrator plays it, without its signals, render delay or account: the deal comes
+ *        from a shuffled Deck, every hand of the game holds the cards picked by the strategy and draws the rest from
+ *        its own DeckView (what is left of the deck for the first hand, the full deck without the held cards for the
+ *        others), and the hands are scored together by the game's evaluateHands(). Credits are only added up, every
+ *        game being paid for whatever the credits already won.
+ *
+ *        Games are played in blocks spread over a thread pool. Each block draws from its own xoshiro256** engine
+ *        seeded from the simulation seed and the block number, so a seed always plays the same games, whatever the
+ *        number of threads.
+ */
+class TurboSimulator
+{
+public:
+    /**
+     * @brief Totals of a simulation
+     */
+    struct Results {
+        quint64          nbGames;        // Games played
+        quint64          nbHands;        // Hands played (nbGames times the hands per game)
+        quint64          creditsBet;     // Credits bet on all the hands
+        quint64          creditsWon;     // Credits won by all the hands
+        QVector<quint64> handsByRow;     // Histogram of the final hands: number of hands hitting each paytable row
+
+        /**
+         * @brief      Credits won per credit bet (e.g. 0.995 for a 99.5% game)
+         */
+        double gameReturn() const;
+    };
+
+    /**
+     * @brief      Prepares simulations of a game
+     *
+     * @param[in]  game           game played, it must outlive the simulator (its evaluateHands() must be thread-safe)
+     * @param[in]  nbCreditsBet   number of credits bet on each hand (1 to 5)
+     * @param[in]  nbHands        number of hands played per game, all holding the same cards
+     *
+     * @exception  runtime_error will be raised if the bet is not valid for the game or there is no hand to play
+     */
+    TurboSimulator(PokerGame *game, quint32 nbCreditsBet, quint32 nbHands = 1);
+
+    /**
+     * @brief      Plays games
+     *
+     * @param[in]  nbGames        number of games to play
+     * @param[in]  strategy       strategy picking the holds of every deal
+     * @param[in]  seed           seed of the games played
+     * @param[in]  nbThreads      number of threads sharing the games (defaults to one per core)
+     *
+     * @return     the totals of all the games
+     */
+    Results run(quint64 nbGames, const HoldStrategy &strategy, quint64 seed, int nbThreads = 0) const;
+
+    /**
+     * @brief      Writes the histogram of a simulation as a table: the hands of each paytable row, how often the row
+     *             was hit and its share of the return, followed by the totals
+     *
+     * @param[in]  results        totals returned by run()
+     * @param[out] out            stream the table is written to
+     */
+    void writeHistogram(const Results &results, QTextStream &out) const;
+
+    /// Number of games drawn from the same engine, and handed to a thread at a time
+    static const quint64 kGamesPerBlock = 4096;
+
+private:
+    // Plays blocks of games until there are none left
+    class BlockWorker;
+
+    /**
+     * @brief      Plays a block of consecutive games
+     *
+     * @param[in]  firstGame      number of the first game of the block, a multiple of kGamesPerBlock
+     * @param[in]  nbGames        number of games of the block (kGamesPerBlock, fewer for the last block)
+     * @param[in]  strategy       strategy picking the holds
+     * @param[in]  seed           seed of the games played
+     * @param[out] results        totals the games of the block are added to
+     */
+    void playBlock(quint64 firstGame, quint64 nbGames, const HoldStrategy &strategy, quint64 seed,
+                   Results &results) const;
+
+    PokerGame       *_game;
+    quint32          _nbCreditsBet;
+    quint32          _nbHands;
+    QVector<quint32> _creditsByRow;   // Credits paid by each paytable row for the bet
+};
+
+#endif // TURBOSIMULATOR_H
@@ -0,0 +1,45 @@
+# VidPokerTerm
+# Copyright (c) 2020 Daniel Brook (danb358 {at} gmail {dot} com)
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Here we are building a command-line tool to analyze the paytables of the games in the
+# core poker library (libpokerbe.a), e.g. to compute their exact theoretical return.
+
+QT += core
+QT -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+# The following define makes your compiler emit warnings if you use
+# any Qt feature that has been marked deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+TARGET = pokerrtp
+TEMPLATE = app
+
+DESTDIR = $$OUT_PWD/../bin
+
+LIBS *= -L$$DESTDIR -lpokerbe
+
+INCLUDEPATH += $$PWD \
+    $$PWD/../poker
+
+PRE_TARGETDEPS += $$OUT_PWD/../bin/libpokerbe.a
+
+SOURCES += \
+    $$PWD/rtp_main.cpp
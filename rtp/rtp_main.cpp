@@ -0,0 +1,223 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "drawoutcomes.h"
+#include "jacksorbetter.h"
+#include "paytableoptimizer.h"
+#include "returncalculator.h"
+#include "strategytable.h"
+#include "turbosimulator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QScopedPointer>
+#include <QTextStream>
+#include <QThread>
+
+#include <exception>
+
+/**
+ * pokerrtp: computes the exact theoretical return of a game's paytable under optimal play
+ *
+ *     pokerrtp --game jacks --bet 5
+ *
+ * With --strategy, it also writes the strategy file of the game and bet (see StrategyTable) for the game to use:
+ *
+ *     pokerrtp --game jacks --bet 5 --strategy ./bin
+ *
+ * With --outcomes, the draw outcomes of the game (see DrawOutcomes) are loaded from the file, or counted and saved
+ * there if it does not exist yet. Returns of the other bets (or of edited paytables) are then computed without scoring
+ * hands:
+ *
+ *     pokerrtp --game jacks --bet 1 --outcomes jacks.vpdraws
+ *
+ * With --target, it searches payouts around the game's paytable instead (see PaytableOptimizer) and lists the
+ * paytables whose return is the closest to the target, with their variance:
+ *
+ *     pokerrtp --game jacks --bet 5 --target 97.3 --radius 1 --candidates 10
+ *
+ * With --simulate, it plays that many games under optimal play instead (see TurboSimulator) and writes the histogram
+ * of the hands they ended on, to check the return empirically or soak test the game. --seed replays the same games:
+ *
+ *     pokerrtp --game jacks --bet 5 --simulate 100000000 --hands 3 --seed 42
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("pokerrtp");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Computes the exact return of a video poker paytable under optimal play.");
+    parser.addHelpOption();
+    QCommandLineOption gameOption(QStringList() << "g" << "game",
+                                  QCoreApplication::translate("main", "Game to analyze: jacks (bonus is not ready)."),
+                                  "game", "jacks");
+    QCommandLineOption betOption(QStringList() << "b" << "bet",
+                                 QCoreApplication::translate("main", "Credits bet per hand (1 to 5)."),
+                                 "credits", "5");
+    QCommandLineOption threadsOption(QStringList() << "t" << "threads",
+                                     QCoreApplication::translate("main", "Worker threads (default: one per core)."),
+                                     "count", QString::number(QThread::idealThreadCount()));
+    QCommandLineOption strategyOption(QStringList() << "s" << "strategy",
+                                      QCoreApplication::translate("main", "Also write the strategy file there."),
+                                      "directory");
+    QCommandLineOption outcomesOption(QStringList() << "o" << "outcomes",
+                                      QCoreApplication::translate("main", "Load (or count and save) draw outcomes."),
+                                      "file");
+    QCommandLineOption targetOption(QStringList() << "target",
+                                    QCoreApplication::translate("main", "Search paytables returning this (in %)."),
+                                    "percent");
+    QCommandLineOption radiusOption(QStringList() << "radius",
+                                    QCoreApplication::translate("main", "Payout change searched (per credit bet)."),
+                                    "credits", "1");
+    QCommandLineOption candidatesOption(QStringList() << "c" << "candidates",
+                                        QCoreApplication::translate("main", "Number of paytables listed."),
+                                        "count", "10");
+    QCommandLineOption simulateOption(QStringList() << "simulate",
+                                      QCoreApplication::translate("main", "Play this many games and list the hands."),
+                                      "games");
+    QCommandLineOption handsOption(QStringList() << "hands",
+                                   QCoreApplication::translate("main", "Hands per simulated game."),
+                                   "count", "1");
+    QCommandLineOption seedOption(QStringList() << "seed",
+                                  QCoreApplication::translate("main", "Seed of the simulated games (default: random)."),
+                                  "seed");
+    parser.addOption(gameOption);
+    parser.addOption(betOption);
+    parser.addOption(threadsOption);
+    parser.addOption(strategyOption);
+    parser.addOption(outcomesOption);
+    parser.addOption(targetOption);
+    parser.addOption(radiusOption);
+    parser.addOption(candidatesOption);
+    parser.addOption(simulateOption);
+    parser.addOption(handsOption);
+    parser.addOption(seedOption);
+    parser.process(a);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QScopedPointer<PokerGame> game;
+    const QString gameName = parser.value(gameOption);
+    if (gameName == "jacks") {
+        game.reset(new JacksOrBetter);
+    } else if (gameName == "bonus") {
+        // BonusPoker is still a skeleton that never pays, so its return would be a meaningless 0%
+        err << "Bonus Poker is not implemented yet\n";
+        return 1;
+    } else {
+        err << "Unknown game: " << gameName << "\n";
+        return 1;
+    }
+
+    const quint32 nbCreditsBet = parser.value(betOption).toUInt();
+    const int     nbThreads    = parser.value(threadsOption).toInt();
+
+    try {
+        QElapsedTimer timer;
+        timer.start();
+
+        QScopedPointer<DrawOutcomes> outcomes;
+        if (parser.isSet(outcomesOption)) {
+            const QString outcomesFile = parser.value(outcomesOption);
+            if (QFile::exists(outcomesFile)) {
+                outcomes.reset(new DrawOutcomes(outcomesFile));
+            } else {
+                outcomes.reset(new DrawOutcomes(game.data()));
+                outcomes->save(outcomesFile);
+                out << "Draw outcomes saved to " << outcomesFile << "\n";
+            }
+        } else {
+            outcomes.reset(new DrawOutcomes(game.data()));
+        }
+
+        if (parser.isSet(targetOption)) {
+            const double targetReturn = parser.value(targetOption).toDouble() / 100.0;
+            PaytableOptimizer optimizer(*outcomes, *game, nbCreditsBet);
+            optimizer.setSearchRadius(parser.value(radiusOption).toUInt());
+            out << game->gameName() << ", " << nbCreditsBet << " credit(s) bet: searching paytables returning "
+                << QString::number(targetReturn * 100.0, 'f', 4) << "% on " << nbThreads << " thread(s)...\n";
+            out.flush();
+
+            const QVector<PaytableOptimizer::Candidate> candidates =
+                    optimizer.search(targetReturn, parser.value(candidatesOption).toInt(), nbThreads);
+            for (const PaytableOptimizer::Candidate &candidate : candidates) {
+                out << QString::number(candidate.gameReturn * 100.0, 'f', 4) << "%, variance "
+                    << QString::number(candidate.variance, 'f', 2) << ":";
+                for (int row = 0; row < candidate.creditsByRow.size(); ++row) {
+                    if (candidate.creditsByRow[row] != optimizer.baseCredits()[row]) {
+                        out << " " << optimizer.rowNames()[row] << " " << candidate.creditsByRow[row] << " (was "
+                            << optimizer.baseCredits()[row] << ")";
+                    }
+                }
+                out << "\n";
+            }
+            out << "Searched in " << timer.elapsed() / 1000.0 << " s\n";
+            return 0;
+        }
+
+        if (parser.isSet(simulateOption)) {
+            const quint64 nbGames = parser.value(simulateOption).toULongLong();
+            const quint64 seed    = parser.isSet(seedOption) ? parser.value(seedOption).toULongLong() :
+                                                               QRandomGenerator::system()->generate64();
+            const HoldSolver          solver(*outcomes, *game, nbCreditsBet);
+            const OptimalHoldStrategy strategy(solver);
+            TurboSimulator            simulator(game.data(), nbCreditsBet, parser.value(handsOption).toUInt());
+            out << game->gameName() << ", " << nbCreditsBet << " credit(s) bet: playing " << nbGames
+                << " game(s) with seed " << seed << " on " << nbThreads << " thread(s)...\n";
+            out.flush();
+
+            timer.restart();
+            const TurboSimulator::Results results = simulator.run(nbGames, strategy, seed, nbThreads);
+            const double seconds = timer.elapsed() / 1000.0;
+            simulator.writeHistogram(results, out);
+            out << "Played in " << seconds << " s";
+            if (seconds > 0.0) {
+                out << " (" << qRound64(results.nbGames / seconds) << " games/s)";
+            }
+            out << "\n";
+            return 0;
+        }
+
+        ReturnCalculator calculator(*outcomes, *game, nbCreditsBet);
+        out << game->gameName() << ", " << nbCreditsBet << " credit(s) bet: tables built in " << timer.elapsed()
+            << " ms, solving all deals on " << nbThreads << " thread(s)...\n";
+        out.flush();
+
+        if (parser.isSet(strategyOption)) {
+            const QString strategyFile = QDir(parser.value(strategyOption)).filePath(
+                                             StrategyTable::fileName(*game, nbCreditsBet));
+            StrategyTable::write(strategyFile, calculator.solver(), game->payTableHash());
+            out << "Strategy written to " << strategyFile << " (" << timer.elapsed() << " ms)\n";
+            out.flush();
+        }
+
+        const double gameReturn = calculator.computeReturn(nbThreads);
+        out << "Return: " << QString::number(gameReturn * 100.0, 'f', 4) << "% (" << timer.elapsed() / 1000.0
+            << " s)\n";
+    } catch (std::runtime_error &exception) {
+        err << "ERROR: " << exception.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
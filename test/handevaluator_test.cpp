@@ -0,0 +1,164 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "handevaluator_test.h"
+
+#include "commonhandanalysis.h"
+#include "handevaluator.h"
+#include "jacksorbetter.h"
+
+namespace {
+// Number of cards in a full French deck and number of distinct 5-card hands that can be made from it
+const quint8  kDeckSize    = PlayingCard::kNbCards;
+const quint32 kNbFiveCards = 2598960;
+
+// Runs the reference predicates in the same best-to-worst order that Jacks or Better originally did
+HandEvaluator::HandCategory referenceCategory(QVector<PlayingCard> hand)
+{
+    HandAnalysis::sortHandVector(hand);
+    if (HandAnalysis::RoyalFlush(hand)) {
+        return HandEvaluator::ROYAL_FLUSH;
+    } else if (HandAnalysis::StraightFlush(hand)) {
+        return HandEvaluator::STRAIGHT_FLUSH;
+    } else if (HandAnalysis::FourOfAKind(hand)) {
+        return HandEvaluator::FOUR_OF_A_KIND;
+    } else if (HandAnalysis::FullHouse(hand)) {
+        return HandEvaluator::FULL_HOUSE;
+    } else if (HandAnalysis::Flush(hand)) {
+        return HandEvaluator::FLUSH;
+    } else if (HandAnalysis::Straight(hand)) {
+        return HandEvaluator::STRAIGHT;
+    } else if (HandAnalysis::ThreeOfAKind(hand)) {
+        return HandEvaluator::THREE_OF_A_KIND;
+    } else if (HandAnalysis::TwoPair(hand)) {
+        return HandEvaluator::TWO_PAIR;
+    }
+    QVector<PlayingCard::CardValue> matches;
+    if (HandAnalysis::NOfAKind(2, hand, matches) == 1) {
+        return HandEvaluator::ONE_PAIR;
+    }
+    return HandEvaluator::HIGH_CARD;
+}
+}
+
+void TestHandEvaluator::testCategoryFrequencies()
+{
+    // Every one of the 2,598,960 hands falls into exactly one category, with well-known frequencies
+    const QVector<quint32> expectedCounts = {1302540, 1098240, 123552, 54912, 10200, 5108, 3744, 624, 36, 4};
+    QVector<quint32>       actualCounts(expectedCounts.size(), 0);
+    quint32                nbHands = 0;
+
+    for (quint8 c1 = 0; c1 < kDeckSize; ++c1) {
+        for (quint8 c2 = c1 + 1; c2 < kDeckSize; ++c2) {
+            for (quint8 c3 = c2 + 1; c3 < kDeckSize; ++c3) {
+                for (quint8 c4 = c3 + 1; c4 < kDeckSize; ++c4) {
+                    for (quint8 c5 = c4 + 1; c5 < kDeckSize; ++c5) {
+                        const quint64 cardSet = (Q_UINT64_C(1) << c1) | (Q_UINT64_C(1) << c2) |
+                                                (Q_UINT64_C(1) << c3) | (Q_UINT64_C(1) << c4) |
+                                                (Q_UINT64_C(1) << c5);
+                        ++actualCounts[HandEvaluator::evaluate(cardSet).category];
+                        ++nbHands;
+                    }
+                }
+            }
+        }
+    }
+
+    QCOMPARE(nbHands, kNbFiveCards);
+    QCOMPARE(actualCounts, expectedCounts);
+}
+
+void TestHandEvaluator::testAgainstReferenceAnalysis()
+{
+    // The reference analysis is slow, so compare a spread-out sample of the full hand space (every 97th hand)
+    quint32 handNumber = 0;
+    for (quint8 c1 = 0; c1 < kDeckSize; ++c1) {
+        for (quint8 c2 = c1 + 1; c2 < kDeckSize; ++c2) {
+            for (quint8 c3 = c2 + 1; c3 < kDeckSize; ++c3) {
+                for (quint8 c4 = c3 + 1; c4 < kDeckSize; ++c4) {
+                    for (quint8 c5 = c4 + 1; c5 < kDeckSize; ++c5) {
+                        if (handNumber++ % 97 != 0) {
+                            continue;
+                        }
+
+                        // Deliberately shuffle the card order a little, the evaluator must not care
+                        Hand hand(PlayingCard::fromIndex(c3), PlayingCard::fromIndex(c1),
+                                  PlayingCard::fromIndex(c5), PlayingCard::fromIndex(c2),
+                                  PlayingCard::fromIndex(c4));
+                        QVector<PlayingCard> handVec = hand.handToVector();
+
+                        const HandEvaluator::Evaluation handValue = HandEvaluator::evaluate(hand);
+                        QCOMPARE(handValue.category, referenceCategory(handVec));
+
+                        // Jacks or Better pays on the rank of the pair
+                        if (handValue.category == HandEvaluator::ONE_PAIR) {
+                            QCOMPARE(handValue.rank >= PlayingCard::JACK, HandAnalysis::JacksOrBetter(handVec));
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void TestHandEvaluator::testBatchMatchesScalar()
+{
+    QVector<quint64> cardSets;
+    cardSets.reserve(kNbFiveCards);
+    for (quint8 c1 = 0; c1 < kDeckSize; ++c1) {
+        for (quint8 c2 = c1 + 1; c2 < kDeckSize; ++c2) {
+            for (quint8 c3 = c2 + 1; c3 < kDeckSize; ++c3) {
+                for (quint8 c4 = c3 + 1; c4 < kDeckSize; ++c4) {
+                    for (quint8 c5 = c4 + 1; c5 < kDeckSize; ++c5) {
+                        cardSets.push_back((Q_UINT64_C(1) << c1) | (Q_UINT64_C(1) << c2) | (Q_UINT64_C(1) << c3) |
+                                           (Q_UINT64_C(1) << c4) | (Q_UINT64_C(1) << c5));
+                    }
+                }
+            }
+        }
+    }
+
+    // Leave a few hands off the end so the partial-vector tail is exercised too
+    const int nbHands = cardSets.size() - 3;
+    QVector<HandEvaluator::Evaluation> batchResults(nbHands);
+    HandEvaluator::evaluate(cardSets.constData(), nbHands, batchResults.data());
+    for (int handIdx = 0; handIdx < nbHands; ++handIdx) {
+        const HandEvaluator::Evaluation scalarResult = HandEvaluator::evaluate(cardSets[handIdx]);
+        QCOMPARE(batchResults[handIdx].category, scalarResult.category);
+        QCOMPARE(batchResults[handIdx].rank, scalarResult.rank);
+    }
+
+    // Games scoring a whole draw at once must agree with scoring the hands one at a time
+    JacksOrBetter JOB;
+    QVector<Hand> hands;
+    for (int handIdx = 0; handIdx < cardSets.size(); handIdx += 25013) {
+        Hand hand;
+        for (quint8 cardIdx = 0; cardIdx < kDeckSize; ++cardIdx) {
+            if (cardSets[handIdx] & (Q_UINT64_C(1) << cardIdx)) {
+                hand.addCard(PlayingCard::fromIndex(cardIdx));
+            }
+        }
+        hands.push_back(hand);
+    }
+    QVector<PokerGame::HandResult> handResults(hands.size());
+    JOB.evaluateHands(hands.constData(), hands.size(), 5, handResults.data());
+    for (int handIdx = 0; handIdx < hands.size(); ++handIdx) {
+        const PokerGame::HandResult singleResult = JOB.evaluateHand(hands[handIdx], 5);
+        QCOMPARE(handResults[handIdx].payoutIdx, singleResult.payoutIdx);
+        QCOMPARE(handResults[handIdx].creditsWon, singleResult.creditsWon);
+    }
+}
@@ -0,0 +1,38 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HANDEVALUATOR_TEST_H
+#define HANDEVALUATOR_TEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+/**
+ * @brief TestHandEvaluator validates the table-driven evaluator (handevaluator.h/cpp) against known poker hand
+ *        frequencies and against the reference implementation in commonhandanalysis.h/cpp, and checks that the batch
+ *        (SIMD) evaluator agrees with the scalar one
+ */
+class TestHandEvaluator : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testCategoryFrequencies();
+    void testAgainstReferenceAnalysis();
+    void testBatchMatchesScalar();
+};
+
+#endif // HANDEVALUATOR_TEST_H
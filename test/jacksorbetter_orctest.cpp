@@ -18,10 +18,67 @@
 #include "jacksorbetter_orctest.h"
 
 #include "account.h"
+#include "drawsampler.h"
 #include "gameorchestrator.h"
 #include "jacksorbetter.h"
 
+#include <QtAlgorithms>
+
+#include <cmath>
+#include <limits>
+
 namespace {
+/**
+ * @brief chiSquare measures how far the rows some hands ended on are from a distribution, the rows expected fewer
+ *        than 5 times being pooled into a single one (a hand on a row that cannot be hit is infinitely far)
+ *
+ * @param[in]  observed       number of hands that ended on each row
+ * @param[in]  distribution   relative probability of each row
+ * @param[out] degrees        degrees of freedom of the statistic
+ */
+double chiSquare(const QVector<quint32> &observed, const QVector<quint32> &distribution, int &degrees)
+{
+    double nbObserved = 0.0;
+    double nbCases    = 0.0;
+    for (int row = 0; row < observed.size(); ++row) {
+        nbObserved += observed[row];
+        nbCases    += distribution[row];
+    }
+
+    double statistic      = 0.0;
+    double pooledExpected = 0.0;
+    double pooledObserved = 0.0;
+    int    nbBins         = 0;
+    for (int row = 0; row < observed.size(); ++row) {
+        const double expected = nbObserved * distribution[row] / nbCases;
+        if (expected < 5.0) {
+            pooledExpected += expected;
+            pooledObserved += observed[row];
+        } else {
+            statistic += (observed[row] - expected) * (observed[row] - expected) / expected;
+            ++nbBins;
+        }
+    }
+    if (pooledExpected > 0.0) {
+        statistic += (pooledObserved - pooledExpected) * (pooledObserved - pooledExpected) / pooledExpected;
+        ++nbBins;
+    } else if (pooledObserved > 0.0) {
+        statistic = std::numeric_limits<double>::infinity();
+    }
+    degrees = nbBins - 1;
+    return statistic;
+}
+
+/**
+ * @brief chiSquareLimit is the value a chi-square statistic only exceeds with a probability of 0.001 (Wilson-Hilferty
+ *        approximation)
+ */
+double chiSquareLimit(int degrees)
+{
+    const double spread = 2.0 / (9.0 * degrees);
+    return degrees * std::pow(1.0 - spread + 3.09 * std::sqrt(spread), 3.0);
+}
+
 /**
  * @brief initAndPlayOneRound initializes a game, then holds the cards requested and returns the first hand (before
  *        the holds were set) and the final hand (the result of replacing cards in the deck that were not held)
@@ -168,6 +225,304 @@ void JacksOrBetter_OrcTest::testSingleHandMultipleGames()
     QCOMPARE(expectedSameCards, actualSameCards);
 }
 
+void JacksOrBetter_OrcTest::testMultiHandGameHeldCards()
+{
+    Account playerAcct;
+    playerAcct.add(1000);
+
+    JacksOrBetter    gameJOB;
+    GameOrchestrator orcJOB(&gameJOB, 10, playerAcct, 0);
+
+    // Hold the first two cards, toggling the second one off and on again (it must not end up twice in a deck)
+    orcJOB.dealDraw();
+    const Hand firstHand = orcJOB.retrieveHand(0);
+    orcJOB.hold(0, true);
+    orcJOB.hold(1, true);
+    orcJOB.hold(1, false);
+    orcJOB.hold(1, true);
+
+    // Only the primary hand holds them until the draw starts
+    QCOMPARE(orcJOB.retrieveHand(0).holdMask(), quint8(0x03));
+    QCOMPARE(orcJOB.retrieveHand(9).holdMask(), quint8(0));
+    QVERIFY(orcJOB.retrieveHand(9).cardAt(0).fakeCard());
+    orcJOB.dealDraw();
+
+    // Every hand keeps the held cards and draws 3 other distinct cards
+    for (qint32 handIdx = 0; handIdx < 10; ++handIdx) {
+        const Hand finalHand = orcJOB.retrieveHand(handIdx);
+        QCOMPARE(finalHand.cardAt(0), firstHand.cardAt(0));
+        QCOMPARE(finalHand.cardAt(1), firstHand.cardAt(1));
+        QCOMPARE(finalHand.holdMask(), quint8(0x03));
+        QCOMPARE(qPopulationCount(finalHand.cardSet()), 5u);
+    }
+}
+
+void JacksOrBetter_OrcTest::testPreDrawnHands()
+{
+    Account playerAcct;
+    playerAcct.add(1000);
+
+    JacksOrBetter    gameJOB;
+    GameOrchestrator orcJOB(&gameJOB, 100, playerAcct, 0);
+
+    // The secondary hands draw their cards before the holds are known: whatever is held (even all of the cards drawn
+    // beforehand), every hand keeps the held cards and fills the others with distinct cards that were not held
+    for (quint8 nbHeld = 0; nbHeld <= Hand::kCardsPerHand; ++nbHeld) {
+        orcJOB.dealDraw();
+        const Hand firstHand = orcJOB.retrieveHand(0);
+        for (quint8 cardIdx = 0; cardIdx < nbHeld; ++cardIdx) {
+            orcJOB.hold(cardIdx, true);
+        }
+        orcJOB.dealDraw();
+
+        for (qint32 handIdx = 1; handIdx < 100; ++handIdx) {
+            const Hand finalHand = orcJOB.retrieveHand(handIdx);
+            QCOMPARE(qPopulationCount(finalHand.cardSet()), 5u);
+            for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+                QVERIFY(!finalHand.cardAt(cardIdx).fakeCard());
+                if (cardIdx < nbHeld) {
+                    QCOMPARE(finalHand.cardAt(cardIdx), firstHand.cardAt(cardIdx));
+                }
+            }
+        }
+    }
+}
+
+void JacksOrBetter_OrcTest::testSeededGameReplay()
+{
+    const quint64 seed = Q_UINT64_C(0x5EED5EED5EED5EED);
+    Account       playerAcct;
+    playerAcct.add(1000);
+    JacksOrBetter gameJOB;
+
+    // Play three 5-hand games holding the first card, remembering the last one
+    GameOrchestrator recorded(&gameJOB, 5, playerAcct, 0);
+    recorded.setGameSeed(seed);
+    for (int game = 0; game < 3; ++game) {
+        recorded.dealDraw();
+        recorded.hold(0, true);
+        recorded.dealDraw();
+    }
+    QCOMPARE(recorded.gameNumber(), quint64(2));
+
+    // Replaying game 2 of the seed with the same hold gives back every hand, card for card (a deal refused for lack
+    // of credits not using up the game number)
+    Account          replayAcct;
+    GameOrchestrator replayed(&gameJOB, 5, replayAcct, 0);
+    replayed.setGameSeed(seed, 2);
+    replayed.dealDraw();
+    QVERIFY(!replayed.isGameInProgress());
+    replayAcct.add(5);
+    replayed.dealDraw();
+    QCOMPARE(replayed.gameNumber(), quint64(2));
+    replayed.hold(0, true);
+    replayed.dealDraw();
+    for (qint32 handIdx = 0; handIdx < 5; ++handIdx) {
+        QCOMPARE(replayed.retrieveHand(handIdx).cardSet(), recorded.retrieveHand(handIdx).cardSet());
+    }
+}
+
+void JacksOrBetter_OrcTest::testParallelDraw()
+{
+    const quint64 seed = Q_UINT64_C(0x5EED5EED5EED5EED);
+    JacksOrBetter gameJOB;
+
+    // The same 100-hand game drawn on the orchestrator's thread alone and on 4 threads
+    Account          serialAcct;
+    Account          parallelAcct;
+    GameOrchestrator serial(&gameJOB, 100, serialAcct, 0);
+    GameOrchestrator parallel(&gameJOB, 100, parallelAcct, 0);
+    serial.setDrawThreadCount(1);
+    parallel.setDrawThreadCount(4);
+    serial.setGameSeed(seed);
+    parallel.setGameSeed(seed);
+    serialAcct.add(1000);
+    parallelAcct.add(1000);
+    serial.dealDraw();
+    serial.hold(2, true);
+    serial.dealDraw();
+    parallel.dealDraw();
+    parallel.hold(2, true);
+    parallel.dealDraw();
+
+    // Every hand is the same whichever thread drew it, keeps the held card, and is paid
+    const PlayingCard heldCard = serial.retrieveHand(0).cardAt(2);
+    quint32           totalWon = 0;
+    for (qint32 handIdx = 0; handIdx < 100; ++handIdx) {
+        const Hand finalHand = parallel.retrieveHand(handIdx);
+        QCOMPARE(finalHand.cardSet(), serial.retrieveHand(handIdx).cardSet());
+        QCOMPARE(finalHand.cardAt(2), heldCard);
+        QCOMPARE(qPopulationCount(finalHand.cardSet()), 5u);
+        totalWon += gameJOB.evaluateHand(finalHand, 1).creditsWon;
+    }
+    QCOMPARE(parallelAcct.balance(), 900 + totalWon);
+    QCOMPARE(serialAcct.balance(), parallelAcct.balance());
+}
+
+void JacksOrBetter_OrcTest::testSnapshotSignals()
+{
+    const quint64 seed = Q_UINT64_C(0x5EED5EED5EED5EED);
+    JacksOrBetter gameJOB;
+
+    // The same seeded games played with a signal per card and with snapshots (crediting once per draw)
+    Account          perCardAcct;
+    Account          snapshotAcct;
+    GameOrchestrator perCard(&gameJOB, 10, perCardAcct, 0);
+    GameOrchestrator snapshots(&gameJOB, 10, snapshotAcct, 0);
+    snapshots.setSnapshotSignals(true);
+    perCard.setGameSeed(seed);
+    snapshots.setGameSeed(seed);
+    perCardAcct.add(1000);
+    snapshotAcct.add(1000);
+    for (int game = 0; game < 20; ++game) {
+        perCard.dealDraw();
+        perCard.hold(0, true);
+        perCard.dealDraw();
+        snapshots.dealDraw();
+        snapshots.hold(0, true);
+        snapshots.dealDraw();
+    }
+
+    // Both modes play the same hands and pay the same credits
+    for (qint32 handIdx = 0; handIdx < 10; ++handIdx) {
+        QCOMPARE(snapshots.retrieveHand(handIdx).cardSet(), perCard.retrieveHand(handIdx).cardSet());
+    }
+    QCOMPARE(snapshotAcct.balance(), perCardAcct.balance());
+    QVERIFY(!snapshots.isGameInProgress());
+}
+
+void JacksOrBetter_OrcTest::testAnimatedReveal()
+{
+    Account playerAcct;
+    playerAcct.add(100);
+    JacksOrBetter    gameJOB;
+    GameOrchestrator orcJOB(&gameJOB, 3, playerAcct, 150);
+
+    // With a render delay, the deal returns before its cards are turned (no event loop runs here, so no tick either)
+    // and the cards still face down cannot be held
+    orcJOB.dealDraw();
+    QVERIFY(orcJOB.isGameInProgress());
+    orcJOB.hold(0, true);
+    QVERIFY(!orcJOB.retrieveHand(0).cardHeld(0));
+
+    // Skipping the animation turns them all at once
+    orcJOB.skipAnimation();
+    orcJOB.hold(0, true);
+    QVERIFY(orcJOB.retrieveHand(0).cardHeld(0));
+    const PlayingCard heldCard = orcJOB.retrieveHand(0).cardAt(0);
+
+    // The draw is revealed the same way, a deal-draw request in the meantime only skipping to the end of the game
+    orcJOB.dealDraw();
+    QVERIFY(orcJOB.isGameInProgress());
+    orcJOB.hold(0, false);
+    orcJOB.dealDraw();
+    QVERIFY(!orcJOB.isGameInProgress());
+
+    quint32 totalWon = 0;
+    for (qint32 handIdx = 0; handIdx < 3; ++handIdx) {
+        QCOMPARE(orcJOB.retrieveHand(handIdx).cardAt(0), heldCard);
+        totalWon += gameJOB.evaluateHand(orcJOB.retrieveHand(handIdx), 1).creditsWon;
+    }
+    QCOMPARE(playerAcct.balance(), 97 + totalWon);
+}
+
+void JacksOrBetter_OrcTest::testUltraMode()
+{
+    // Every hand of a 10,000-hand game is paid, whether it is one of the sample hands revealed or not
+    for (bool snapshotMode : {false, true}) {
+        Account playerAcct;
+        playerAcct.add(20000);
+        JacksOrBetter    gameJOB;
+        GameOrchestrator orcJOB(&gameJOB, 10000, playerAcct, 0);
+        orcJOB.setUltraMode(true);
+        orcJOB.setSnapshotSignals(snapshotMode);
+
+        orcJOB.dealDraw();
+        orcJOB.hold(0, true);
+        orcJOB.dealDraw();
+        QVERIFY(!orcJOB.isGameInProgress());
+
+        quint32 totalWon = 0;
+        for (qint32 handIdx = 0; handIdx < 10000; ++handIdx) {
+            const Hand finalHand = orcJOB.retrieveHand(handIdx);
+            QCOMPARE(finalHand.cardAt(0), orcJOB.retrieveHand(0).cardAt(0));
+            totalWon += gameJOB.evaluateHand(finalHand, 1).creditsWon;
+        }
+        QCOMPARE(playerAcct.balance(), 10000 + totalWon);
+    }
+}
+
+void JacksOrBetter_OrcTest::testSampledDraws()
+{
+    const quint64 seed = Q_UINT64_C(0x5EED5EED5EED5EED);
+    JacksOrBetter gameJOB;
+    DrawSampler   sampler(&gameJOB);
+    QVector<QPair<const QString, int>> payTable;
+    gameJOB.currentPayTable(1, payTable);
+
+    // Holding the whole hand, every hand not dealt ends on the row of the primary hand
+    Account          heldAcct;
+    GameOrchestrator heldOrc(&gameJOB, 10000, heldAcct, 0);
+    heldAcct.add(10000);
+    heldOrc.setUltraMode(true);
+    heldOrc.setSampledDraws(true);
+    heldOrc.dealDraw();
+    for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+        heldOrc.hold(cardIdx, true);
+    }
+    heldOrc.dealDraw();
+    QCOMPARE(heldAcct.balance(), 10000 * gameJOB.evaluateHand(heldOrc.retrieveHand(0), 1).creditsWon);
+    QCOMPARE(heldOrc.retrieveHand(GameOrchestrator::kUltraSampleHands + 1).cardSet(), quint64(0));
+
+    // Whether the hands are dealt card by card or sampled, the summary of the draw pays every hand by its row, and the
+    // rows of the hands drawing follow the exact distribution of the hold
+    for (bool sampledDraws : {false, true}) {
+        for (quint8 nbHeld : {0, 1, 3}) {
+            Account          playerAcct;
+            GameOrchestrator orcJOB(&gameJOB, 10000, playerAcct, 0);
+            playerAcct.add(10000);
+            orcJOB.setUltraMode(true);
+            orcJOB.setSampledDraws(sampledDraws);
+            orcJOB.setGameSeed(seed, nbHeld);
+
+            QVector<quint32> summaryRows;
+            quint32          summaryWinnings = 0;
+            QObject::connect(&orcJOB, &GameOrchestrator::handsSummary,
+                             [&](QVector<quint32> handsByRow, quint32 totalWinnings) {
+                summaryRows     = handsByRow;
+                summaryWinnings = totalWinnings;
+            });
+
+            orcJOB.dealDraw();
+            for (quint8 cardIdx = 0; cardIdx < nbHeld; ++cardIdx) {
+                orcJOB.hold(cardIdx, true);
+            }
+            orcJOB.dealDraw();
+            QCOMPARE(summaryRows.size(), gameJOB.nbPayTableRows());
+
+            quint32 nbHands     = 0;
+            quint32 rowWinnings = 0;
+            for (int row = 0; row < summaryRows.size(); ++row) {
+                nbHands     += summaryRows[row];
+                rowWinnings += summaryRows[row] * static_cast<quint32>(payTable[row].second);
+            }
+            QCOMPARE(nbHands, quint32(10000));
+            QCOMPARE(summaryWinnings, rowWinnings);
+            QCOMPARE(playerAcct.balance(), summaryWinnings);
+
+            // The primary hand drew from the rest of the deck, not from the distribution
+            quint64 heldCards = 0;
+            for (quint8 cardIdx = 0; cardIdx < nbHeld; ++cardIdx) {
+                heldCards |= orcJOB.retrieveHand(0).cardAt(cardIdx).cardBit();
+            }
+            --summaryRows[gameJOB.evaluateHand(orcJOB.retrieveHand(0), 1).payoutIdx];
+
+            int degrees = 0;
+            QVERIFY(chiSquare(summaryRows, sampler.rowDistribution(heldCards), degrees) < chiSquareLimit(degrees));
+        }
+    }
+}
+
 void JacksOrBetter_OrcTest::testSingleHandInsufficientFunds()
 {
     // Setup a game with only 2 credits in the account, then try and play 5
@@ -33,6 +33,14 @@ private slots:
     void testSingleHandGame1HoldCard();
     void testSingleHandGameHoldAllCards();
     void testSingleHandMultipleGames();
+    void testMultiHandGameHeldCards();
+    void testPreDrawnHands();
+    void testSeededGameReplay();
+    void testParallelDraw();
+    void testSnapshotSignals();
+    void testAnimatedReveal();
+    void testUltraMode();
+    void testSampledDraws();
     void testSingleHandInsufficientFunds();
     void testBetCycling();
     void testBetMaximum();
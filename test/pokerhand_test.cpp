@@ -18,7 +18,11 @@
 #include "pokerhand_test.h"
 
 // Jacks or Better Payout and Hand Name tests
+#include "deck.h"
+#include "handblock.h"
 #include "jacksorbetter.h"
+#include "randomengine.h"
+#include "randompool.h"
 
 namespace {
 // Test orchestrator function to hopefully make for less repetetive code
@@ -29,7 +33,47 @@ void validateResult(PokerGame &myGame, const Hand &myHand, quint8 credits, quint
     myGame.determineHandAndWin(myHand, credits, retHand, retWinnings);
     QCOMPARE(retWinnings, expWinnings);
     QCOMPARE(retHand, expHand);
+
+    // The string-free API must agree with the string one
+    const PokerGame::HandResult result = myGame.evaluateHand(myHand, credits);
+    QCOMPARE(result.creditsWon, expWinnings);
+    QCOMPARE(myGame.handString(result.payoutIdx), expHand);
 }
+
+// A game only implementing the string API, to check the evaluateHand adapter of the base class
+class StringOnlyGame : public PokerGame
+{
+public:
+    StringOnlyGame() : PokerGame("String Only")
+    {
+        _handPayouts = {
+            {"Flush", {5, 10, 15, 20, 25}},
+            {"",      {0,  0,  0,  0,  0}}
+        };
+    }
+
+    void determineHandAndWin(const Hand &gameHand, quint32 nbCreditsBet, QString &winningHand, quint32 &creditsWon)
+    {
+        const bool flush = gameHand.cardAt(0).suit() == gameHand.cardAt(1).suit() &&
+                           gameHand.cardAt(0).suit() == gameHand.cardAt(2).suit() &&
+                           gameHand.cardAt(0).suit() == gameHand.cardAt(3).suit() &&
+                           gameHand.cardAt(0).suit() == gameHand.cardAt(4).suit();
+        winningHand = flush ? "Flush" : "";
+        creditsWon  = flush ? 5 * nbCreditsBet : 0;
+    }
+};
+
+// A game naming a hand missing from its paytable
+class UnknownRowGame : public StringOnlyGame
+{
+public:
+    void determineHandAndWin(const Hand &gameHand, quint32 nbCreditsBet, QString &winningHand, quint32 &creditsWon)
+    {
+        Q_UNUSED(gameHand);
+        winningHand = "Four Aces";
+        creditsWon  = 80 * nbCreditsBet;
+    }
+};
 }
 
 void TestHands::testJOB_RoyalFlush() {
@@ -413,3 +457,298 @@ void TestHands::testJOB_NoWin()
                    1, 0, "");
     // TODO: how many tests does it make sense to do for "no win" hands?
 }
+
+void TestHands::testPackedCardLayout()
+{
+    QCOMPARE(sizeof(PlayingCard), size_t(1));
+
+    // Every real card round-trips through its index, and indices cover [0, 52) exactly once
+    quint64 allCards = 0;
+    for (quint8 cardIdx = 0; cardIdx < PlayingCard::kNbCards; ++cardIdx) {
+        const PlayingCard card = PlayingCard::fromIndex(cardIdx);
+        QVERIFY(!card.fakeCard());
+        QCOMPARE(card.index(), cardIdx);
+        QVERIFY(card == PlayingCard(card.suit(), card.value()));
+        allCards |= card.cardBit();
+    }
+    QCOMPARE(allCards, (Q_UINT64_C(1) << PlayingCard::kNbCards) - 1);
+
+    // Placeholder cards never show up in a card set
+    QVERIFY(PlayingCard().fakeCard());
+    QCOMPARE(PlayingCard().cardBit(), Q_UINT64_C(0));
+    QVERIFY(PlayingCard() != PlayingCard(PlayingCard::DIAMOND, PlayingCard::TWO));
+}
+
+void TestHands::testHandBitmask()
+{
+    const PlayingCard aceSpades(PlayingCard::SPADE, PlayingCard::ACE);
+    const PlayingCard twoClubs (PlayingCard::CLUB,  PlayingCard::TWO);
+    Hand hand(PlayingCard(PlayingCard::HEART,   PlayingCard::TEN ),
+              PlayingCard(PlayingCard::HEART,   PlayingCard::JACK),
+              PlayingCard(PlayingCard::DIAMOND, PlayingCard::FIVE),
+              aceSpades,
+              PlayingCard(PlayingCard::CLUB,    PlayingCard::KING));
+    QCOMPARE(hand.nbCards(), Hand::kCardsPerHand);
+    QVERIFY(hand.cardSet() & aceSpades.cardBit());
+    QVERIFY(!(hand.cardSet() & twoClubs.cardBit()));
+
+    // Holds are one bit per position
+    QCOMPARE(hand.holdMask(), quint8(0));
+    hand.holdCard(1, true);
+    hand.holdCard(3, true);
+    QCOMPARE(hand.holdMask(), quint8(0x0A));
+    QVERIFY(hand.cardHeld(3));
+    hand.holdCard(3, false);
+    QVERIFY(!hand.cardHeld(3));
+    hand.setHoldMask(Hand::kAllHeld);
+    QVERIFY(hand.cardHeld(0) && hand.cardHeld(4));
+
+    // Replacing a card keeps the card set in sync, including with placeholder cards
+    hand.replaceCard(3, twoClubs);
+    QVERIFY(!(hand.cardSet() & aceSpades.cardBit()));
+    QVERIFY(hand.cardSet() & twoClubs.cardBit());
+    hand.replaceCard(3, PlayingCard());
+    QVERIFY(!(hand.cardSet() & twoClubs.cardBit()));
+
+    hand.reset();
+    QCOMPARE(hand.nbCards(), quint8(0));
+    QCOMPARE(hand.cardSet(), Q_UINT64_C(0));
+    QVERIFY_EXCEPTION_THROWN(hand.setHoldMask(Hand::kAllHeld), std::runtime_error);
+}
+
+void TestHands::testHandBlock()
+{
+    // Hands are edited in place like Hands, each one keeping its own cards, holds and card set
+    HandBlock block(3);
+    QCOMPARE(block.nbHands(), 3);
+    QCOMPARE(block.hand(1).nbCards(), quint8(0));
+    Deck deck(Deck::FULL_FRENCH);
+    deck.shuffle();
+    QVector<Hand> hands(3);
+    for (int handIdx = 0; handIdx < 3; ++handIdx) {
+        for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+            const PlayingCard card = deck.drawCard();
+            hands[handIdx].addCard(card);
+            block.addCard(handIdx, card);
+        }
+    }
+    QVERIFY_EXCEPTION_THROWN(block.addCard(0, deck.drawCard()), std::runtime_error);
+    hands[1].setHoldMask(0x05);
+    block.setHoldMask(1, 0x05);
+    const PlayingCard newCard = deck.drawCard();
+    hands[2].replaceCard(3, newCard);
+    block.replaceCard(2, 3, newCard);
+    for (int handIdx = 0; handIdx < 3; ++handIdx) {
+        QCOMPARE(block.cardSet(handIdx), hands[handIdx].cardSet());
+        QCOMPARE(block.holdMask(handIdx), hands[handIdx].holdMask());
+        QCOMPARE(block.hand(handIdx).handToVector(), hands[handIdx].handToVector());
+    }
+    QVERIFY(block.cardHeld(1, 2) && !block.cardHeld(1, 1));
+
+    // Scoring the card sets gives the results of evaluateHands, through the batch evaluator or the default adapter
+    const Hand royal(PlayingCard(PlayingCard::SPADE, PlayingCard::TEN  ),
+                     PlayingCard(PlayingCard::SPADE, PlayingCard::JACK ),
+                     PlayingCard(PlayingCard::SPADE, PlayingCard::QUEEN),
+                     PlayingCard(PlayingCard::SPADE, PlayingCard::KING ),
+                     PlayingCard(PlayingCard::SPADE, PlayingCard::ACE  ));
+    block.setHand(0, royal);
+    hands[0] = royal;
+    JacksOrBetter  JOB;
+    StringOnlyGame stringGame;
+    PokerGame     *games[] = {&JOB, &stringGame};
+    for (PokerGame *game : games) {
+        PokerGame::HandResult results[3];
+        game->evaluateHands(hands.constData(), 3, 5, results);
+        block.evaluate(game, 5, 0, 3);
+        for (int handIdx = 0; handIdx < 3; ++handIdx) {
+            QCOMPARE(block.result(handIdx).payoutIdx, results[handIdx].payoutIdx);
+            QCOMPARE(block.result(handIdx).creditsWon, results[handIdx].creditsWon);
+        }
+        QCOMPARE(block.totalCredits(0, 3), results[0].creditsWon + results[1].creditsWon + results[2].creditsWon);
+    }
+    QCOMPARE(block.result(0).creditsWon, quint32(25));
+    block.evaluate(&JOB, 5, 0, 1);
+    QCOMPARE(block.result(0).creditsWon, quint32(4000));
+
+    block.reset();
+    QCOMPARE(block.hand(0).nbCards(), quint8(0));
+    QCOMPARE(block.cardSet(0), Q_UINT64_C(0));
+}
+
+void TestHands::testEvaluateHandAdapter()
+{
+    StringOnlyGame game;
+    const Hand flush(PlayingCard(PlayingCard::HEART, PlayingCard::TWO ),
+                     PlayingCard(PlayingCard::HEART, PlayingCard::NINE),
+                     PlayingCard(PlayingCard::HEART, PlayingCard::FIVE),
+                     PlayingCard(PlayingCard::HEART, PlayingCard::KING),
+                     PlayingCard(PlayingCard::HEART, PlayingCard::SIX ));
+    PokerGame::HandResult result = game.evaluateHand(flush, 3);
+    QCOMPARE(result.payoutIdx, quint8(0));
+    QCOMPARE(result.creditsWon, quint32(15));
+
+    const Hand nothing(PlayingCard(PlayingCard::HEART, PlayingCard::TWO ),
+                       PlayingCard(PlayingCard::HEART, PlayingCard::NINE),
+                       PlayingCard(PlayingCard::CLUB,  PlayingCard::FIVE),
+                       PlayingCard(PlayingCard::HEART, PlayingCard::KING),
+                       PlayingCard(PlayingCard::HEART, PlayingCard::SIX ));
+    result = game.evaluateHand(nothing, 3);
+    QCOMPARE(result.payoutIdx, quint8(1));
+    QCOMPARE(result.creditsWon, quint32(0));
+    QVERIFY(game.handString(result.payoutIdx).isEmpty());
+    QVERIFY_EXCEPTION_THROWN(game.handString(2), std::runtime_error);
+
+    // A hand that is not in the paytable is an error rather than a non-winning hand paying credits
+    UnknownRowGame unknownGame;
+    QVERIFY_EXCEPTION_THROWN(unknownGame.evaluateHand(flush, 3), std::runtime_error);
+}
+
+void TestHands::testDeckLazyShuffle()
+{
+    // A deck that was not shuffled deals its cards back in order
+    Deck deck(Deck::FULL_FRENCH);
+    QCOMPARE(deck.drawCard(), PlayingCard(PlayingCard::DIAMOND, PlayingCard::ACE));
+
+    // A shuffled deck deals every card exactly once, including a card taken out and put back in the meantime
+    const PlayingCard putBack(PlayingCard::CLUB, PlayingCard::SEVEN);
+    deck.reset();
+    deck.shuffle();
+    quint64 dealtCards = deck.drawCard().cardBit() | deck.drawCard().cardBit();
+    deck.removeCard(putBack);
+    deck.addCard(putBack);
+    for (quint8 cardIdx = 2; cardIdx < PlayingCard::kNbCards; ++cardIdx) {
+        const quint64 cardBit = deck.drawCard().cardBit();
+        QVERIFY(!(dealtCards & cardBit));
+        dealtCards |= cardBit;
+    }
+    QCOMPARE(dealtCards, (Q_UINT64_C(1) << PlayingCard::kNbCards) - 1);
+    QVERIFY_EXCEPTION_THROWN(deck.drawCard(), std::runtime_error);
+
+    // Every card is as likely to come first (1000 times each on average, a fair deck stays well within 6 sigmas)
+    quint32 firstCardCounts[PlayingCard::kNbCards] = {};
+    for (quint32 deal = 0; deal < PlayingCard::kNbCards * 1000; ++deal) {
+        deck.reset();
+        deck.shuffle();
+        ++firstCardCounts[deck.drawCard().index()];
+    }
+    for (quint8 cardIdx = 0; cardIdx < PlayingCard::kNbCards; ++cardIdx) {
+        QVERIFY(firstCardCounts[cardIdx] > 810 && firstCardCounts[cardIdx] < 1190);
+    }
+}
+
+void TestHands::testDeckCardSet()
+{
+    const PlayingCard sevenOfClubs(PlayingCard::CLUB, PlayingCard::SEVEN);
+    const quint64     fullDeck = (Q_UINT64_C(1) << PlayingCard::kNbCards) - 1;
+    Deck deck(Deck::FULL_FRENCH);
+    QCOMPARE(deck.availableCards(), fullDeck);
+
+    // Removing takes the card out of the set once, adding it back twice is refused
+    deck.removeCard(sevenOfClubs);
+    deck.removeCard(sevenOfClubs);
+    QCOMPARE(deck.availableCards(), fullDeck & ~sevenOfClubs.cardBit());
+    deck.addCard(sevenOfClubs);
+    QVERIFY_EXCEPTION_THROWN(deck.addCard(sevenOfClubs), std::runtime_error);
+    QVERIFY_EXCEPTION_THROWN(deck.addCard(PlayingCard()), std::runtime_error);
+    QCOMPARE(deck.availableCards(), fullDeck);
+
+    // Drawn cards leave the set
+    deck.shuffle();
+    const PlayingCard drawnCard = deck.drawCard();
+    QCOMPARE(deck.availableCards(), fullDeck & ~drawnCard.cardBit());
+}
+
+void TestHands::testRandomEngines()
+{
+    // ChaCha20 block function test vector of RFC 8439 (section 2.3.2)
+    const quint32 key[ChaCha20Engine::kKeyWords] = {0x03020100, 0x07060504, 0x0B0A0908, 0x0F0E0D0C,
+                                                    0x13121110, 0x17161514, 0x1B1A1918, 0x1F1E1D1C};
+    const quint32 nonce[ChaCha20Engine::kNonceWords] = {0x09000000, 0x4A000000, 0x00000000};
+    const quint32 expectedBlock[ChaCha20Engine::kBlockWords] = {0xE4E7F110, 0x15593BD1, 0x1FDD0F50, 0xC47120A3,
+                                                                0xC7F4D1C7, 0x0368C033, 0x9AAA2204, 0x4E6CD4C3,
+                                                                0x466482D2, 0x09AA9F07, 0x05D7C214, 0xA2028BD9,
+                                                                0xD19C12B5, 0xB94E16DE, 0xE883D0CB, 0x4E3C50A2};
+    ChaCha20Engine chaCha(key, nonce, 1);
+    for (quint32 expectedWord : expectedBlock) {
+        QCOMPARE(chaCha.generate(), expectedWord);
+    }
+
+    // xoshiro256** replays its stream from the seed
+    Xoshiro256Engine xoshiro(42);
+    Xoshiro256Engine replay(42);
+    for (int valueIdx = 0; valueIdx < 1000; ++valueIdx) {
+        QCOMPARE(xoshiro.generate(), replay.generate());
+    }
+
+    // Bounded values of every engine stay in range and cover it evenly (1000 times each on average)
+    const RandomEngine::EngineType types[] = {RandomEngine::QT_GENERATOR, RandomEngine::XOSHIRO256,
+                                              RandomEngine::CHACHA20, RandomEngine::PHILOX};
+    for (RandomEngine::EngineType type : types) {
+        QSharedPointer<RandomEngine> engine = RandomEngine::create(type);
+        QCOMPARE(engine->type(), type);
+        quint32 counts[PlayingCard::kNbCards] = {};
+        for (quint32 draw = 0; draw < PlayingCard::kNbCards * 1000; ++draw) {
+            const quint32 value = engine->bounded(PlayingCard::kNbCards);
+            QVERIFY(value < PlayingCard::kNbCards);
+            ++counts[value];
+        }
+        for (quint32 count : counts) {
+            QVERIFY(count > 810 && count < 1190);
+        }
+    }
+    // Philox4x32-10 known answers of Random123, and streams of other hands or games that differ from the first value
+    const quint32 zeros[PhiloxEngine::kBlockWords] = {0, 0, 0, 0};
+    const quint32 ones[PhiloxEngine::kBlockWords]  = {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF};
+    const quint32 expectedZeros[PhiloxEngine::kBlockWords] = {0x6627E8D5, 0xE169C58D, 0xBC57AC4C, 0x9B00DBD8};
+    const quint32 expectedOnes[PhiloxEngine::kBlockWords]  = {0x408F276D, 0x41C83B0E, 0xA20BC7C6, 0x6D5451FD};
+    quint32 philoxBlock[PhiloxEngine::kBlockWords];
+    PhiloxEngine::generateBlock(zeros, zeros, philoxBlock);
+    for (int wordIdx = 0; wordIdx < PhiloxEngine::kBlockWords; ++wordIdx) {
+        QCOMPARE(philoxBlock[wordIdx], expectedZeros[wordIdx]);
+    }
+    PhiloxEngine::generateBlock(ones, ones, philoxBlock);
+    for (int wordIdx = 0; wordIdx < PhiloxEngine::kBlockWords; ++wordIdx) {
+        QCOMPARE(philoxBlock[wordIdx], expectedOnes[wordIdx]);
+    }
+    PhiloxEngine firstHand(7, 3, 0);
+    PhiloxEngine secondHand(7, 3, 1);
+    PhiloxEngine nextGame(7, 4, 0);
+    const quint32 firstValue = firstHand.generate();
+    QVERIFY(firstValue != secondHand.generate());
+    QVERIFY(firstValue != nextGame.generate());
+    QCOMPARE(PhiloxEngine(7, 3, 0).generate(), firstValue);
+
+    QCOMPARE(RandomEngine::typeFromName("xoshiro"), RandomEngine::XOSHIRO256);
+    QVERIFY_EXCEPTION_THROWN(RandomEngine::typeFromName("dice"), std::runtime_error);
+}
+
+void TestHands::testRandomPool()
+{
+    // The service thread fills the ring on its own (giving up after 5 s on a very busy machine)
+    RandomPool pool(RandomEngine::XOSHIRO256);
+    QCOMPARE(pool.type(), RandomEngine::XOSHIRO256);
+    for (int waitIdx = 0; waitIdx < 5000 && pool.nbReady() < RandomPool::kRingSize; ++waitIdx) {
+        QThread::msleep(1);
+    }
+    QCOMPARE(pool.nbReady(), RandomPool::kRingSize);
+
+    // A full ring hands out all its values without falling back
+    for (quint32 valueIdx = 0; valueIdx < RandomPool::kRingSize; ++valueIdx) {
+        pool.generate();
+    }
+    QCOMPARE(pool.nbUnderruns(), quint32(0));
+
+    // A ring that is not filled falls back to generating on the spot, the values being just as good
+    RandomPool drainedPool(RandomEngine::XOSHIRO256, false);
+    quint32    valueCounts[PlayingCard::kNbCards] = {};
+    for (quint32 valueIdx = 0; valueIdx < PlayingCard::kNbCards * 1000; ++valueIdx) {
+        const quint32 value = drainedPool.bounded(PlayingCard::kNbCards);
+        QVERIFY(value < PlayingCard::kNbCards);
+        ++valueCounts[value];
+    }
+    for (quint8 value = 0; value < PlayingCard::kNbCards; ++value) {
+        QVERIFY(valueCounts[value] > 810 && valueCounts[value] < 1190);
+    }
+    QCOMPARE(drainedPool.nbReady(), quint32(0));
+    QVERIFY(drainedPool.nbUnderruns() > 0);
+}
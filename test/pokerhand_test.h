@@ -26,7 +26,11 @@
  *          - commonhandanalysis.h/cpp
  *          - deck.h/cpp
  *          - hand.h/cpp
+ *          - handblock.h/cpp
+ *          - playingcard.h/cpp
  *          - pokergame.h/cpp
+ *          - randomengine.h/cpp
+ *          - randompool.h/cpp
  *          - jacksorbetter.h/cpp
  */
 class TestHands : public QObject
@@ -44,6 +48,15 @@ private slots:
     void testJOB_2Pair();
     void testJOB_JacksOrBetter();
     void testJOB_NoWin();
+
+    void testPackedCardLayout();
+    void testHandBitmask();
+    void testHandBlock();
+    void testEvaluateHandAdapter();
+    void testDeckLazyShuffle();
+    void testDeckCardSet();
+    void testRandomEngines();
+    void testRandomPool();
 };
 
 #endif // POKERHAND_TEST_H
@@ -0,0 +1,495 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "returncalculator_test.h"
+
+#include "account.h"
+#include "bonuspoker.h"
+#include "drawoutcomes.h"
+#include "drawsampler.h"
+#include "gameorchestrator.h"
+#include "handcombinatorics.h"
+#include "holdadvisor.h"
+#include "jacksorbetter.h"
+#include "paytableoptimizer.h"
+#include "returncalculator.h"
+#include "strategytable.h"
+#include "turbosimulator.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QtAlgorithms>
+
+#include <cmath>
+
+namespace {
+// The common 8/5 Jacks or Better paytable: the full house pays 8 and the flush 5 (per credit bet)
+class EightFiveJacks : public JacksOrBetter
+{
+public:
+    EightFiveJacks()
+    {
+        _handPayouts[3].payoutCredits = {8, 16, 24, 32, 40};
+        _handPayouts[4].payoutCredits = {5, 10, 15, 20, 25};
+    }
+};
+
+// Holds a single card, one of a pair when the deal has one (and the first card otherwise): the cards discarded depend
+// on the deal, so secondary hands only play the same game when they draw from the same cards (the other card of the
+// pair is amongst them)
+class SplitPairStrategy : public HoldStrategy
+{
+public:
+    quint8 chooseHold(const Hand &dealtHand) const
+    {
+        for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+            for (quint8 otherIdx = cardIdx + 1; otherIdx < Hand::kCardsPerHand; ++otherIdx) {
+                if (dealtHand.cardAt(cardIdx).value() == dealtHand.cardAt(otherIdx).value()) {
+                    return static_cast<quint8>(1 << cardIdx);
+                }
+            }
+        }
+        return 0x01;
+    }
+};
+
+// Chi-square statistic of two sets of row counts coming from the same distribution, the rows expected fewer than 5
+// times (in either set) being pooled into a single one
+double chiSquareHomogeneity(const QVector<quint64> &first, const QVector<quint64> &second, int &degrees)
+{
+    double nbFirst  = 0.0;
+    double nbSecond = 0.0;
+    for (int row = 0; row < first.size(); ++row) {
+        nbFirst  += first[row];
+        nbSecond += second[row];
+    }
+
+    double statistic    = 0.0;
+    double pooledFirst  = 0.0;
+    double pooledSecond = 0.0;
+    int    nbBins       = 0;
+    const auto addBin = [&](double firstCount, double secondCount) {
+        const double rowShare       = (firstCount + secondCount) / (nbFirst + nbSecond);
+        const double firstExpected  = rowShare * nbFirst;
+        const double secondExpected = rowShare * nbSecond;
+        statistic += (firstCount - firstExpected) * (firstCount - firstExpected) / firstExpected +
+                     (secondCount - secondExpected) * (secondCount - secondExpected) / secondExpected;
+        ++nbBins;
+    };
+    for (int row = 0; row < first.size(); ++row) {
+        const double rowShare = static_cast<double>(first[row] + second[row]) / (nbFirst + nbSecond);
+        if (rowShare * qMin(nbFirst, nbSecond) < 5.0) {
+            pooledFirst  += first[row];
+            pooledSecond += second[row];
+        } else {
+            addBin(first[row], second[row]);
+        }
+    }
+    if (pooledFirst + pooledSecond > 0.0) {
+        addBin(pooledFirst, pooledSecond);
+    }
+    degrees = nbBins - 1;
+    return statistic;
+}
+}  // namespace
+
+void TestReturnCalculator::testColexIndex()
+{
+    // The lowest and highest 5-card sets bound the index range
+    QCOMPARE(HandCombinatorics::colexIndex(Q_UINT64_C(0x1F)), quint32(0));
+    QCOMPARE(HandCombinatorics::colexIndex(Q_UINT64_C(0x1F) << (PlayingCard::kNbCards - 5)),
+             HandCombinatorics::kNbFiveCardHands - 1);
+
+    // Consecutive sets in colex order get consecutive indices
+    quint32 expectedIndex = 0;
+    for (quint8 c3 = 2; c3 < PlayingCard::kNbCards; ++c3) {
+        for (quint8 c2 = 1; c2 < c3; ++c2) {
+            for (quint8 c1 = 0; c1 < c2; ++c1) {
+                const quint64 cardSet = (Q_UINT64_C(1) << c1) | (Q_UINT64_C(1) << c2) | (Q_UINT64_C(1) << c3);
+                QCOMPARE(HandCombinatorics::colexIndex(cardSet), expectedIndex++);
+            }
+        }
+    }
+    QCOMPARE(expectedIndex, HandCombinatorics::binomial(PlayingCard::kNbCards, 3));
+}
+
+void TestReturnCalculator::testCanonicalHands()
+{
+    const QVector<HandCombinatorics::CanonicalHand> classes = HandCombinatorics::canonicalHands();
+    QCOMPARE(quint32(classes.size()), HandCombinatorics::kNbCanonicalHands);
+
+    quint32 totalWeight = 0;
+    for (const HandCombinatorics::CanonicalHand &handClass : classes) {
+        totalWeight += handClass.weight;
+    }
+    QCOMPARE(totalWeight, HandCombinatorics::kNbFiveCardHands);
+
+    // Swapping the suits around does not change the class
+    const Hand hand(PlayingCard(PlayingCard::HEART,   PlayingCard::ACE ),
+                    PlayingCard(PlayingCard::HEART,   PlayingCard::KING),
+                    PlayingCard(PlayingCard::SPADE,   PlayingCard::KING),
+                    PlayingCard(PlayingCard::CLUB,    PlayingCard::TWO ),
+                    PlayingCard(PlayingCard::CLUB,    PlayingCard::NINE));
+    const Hand sameClass(PlayingCard(PlayingCard::DIAMOND, PlayingCard::ACE ),
+                         PlayingCard(PlayingCard::DIAMOND, PlayingCard::KING),
+                         PlayingCard(PlayingCard::HEART,   PlayingCard::KING),
+                         PlayingCard(PlayingCard::SPADE,   PlayingCard::TWO ),
+                         PlayingCard(PlayingCard::SPADE,   PlayingCard::NINE));
+    QCOMPARE(HandCombinatorics::canonicalKey(hand.cardSet()), HandCombinatorics::canonicalKey(sameClass.cardSet()));
+}
+
+void TestReturnCalculator::testFourToARoyal()
+{
+    JacksOrBetter    JOB;
+    ReturnCalculator calculator(&JOB, 5);
+
+    // Sorted by card index the deal is 10, J, Q, K of hearts then the 2 of clubs
+    const Hand deal(PlayingCard(PlayingCard::CLUB,  PlayingCard::TWO  ),
+                    PlayingCard(PlayingCard::HEART, PlayingCard::KING ),
+                    PlayingCard(PlayingCard::HEART, PlayingCard::TEN  ),
+                    PlayingCard(PlayingCard::HEART, PlayingCard::QUEEN),
+                    PlayingCard(PlayingCard::HEART, PlayingCard::JACK ));
+    const ReturnCalculator::HoldValues holds = calculator.solveDealByEnumeration(deal.cardSet());
+
+    // Drawing to the royal: 1 royal (4000), 1 straight flush (250), 7 flushes (30), 6 straights (20), 9 high pairs (5)
+    QCOMPARE(holds.bestHold, quint8(0x0F));
+    QCOMPARE(holds.expectedValue[0x0F], (4000.0 + 250.0 + 7 * 30.0 + 6 * 20.0 + 9 * 5.0) / 47.0);
+
+    // The deal itself does not pay, and keeping the deuce with the hearts can at best make a flush
+    QCOMPARE(holds.expectedValue[HoldSolver::kNbHolds - 1], 0.0);
+    QVERIFY(holds.expectedValue[HoldSolver::kNbHolds - 1] < holds.expectedValue[0x0F]);
+}
+
+void TestReturnCalculator::testSolverMatchesEnumeration()
+{
+    JacksOrBetter    JOB;
+    ReturnCalculator calculator(&JOB, 1);
+
+    // Both ways of valuing the holds sum the same integer payouts, so they must agree exactly
+    const QVector<HandCombinatorics::CanonicalHand> classes = HandCombinatorics::canonicalHands();
+    for (int classIdx = 0; classIdx < classes.size(); classIdx += 4999) {
+        const HoldSolver::HoldValues enumerated = calculator.solveDealByEnumeration(classes[classIdx].cardSet);
+        const HoldSolver::HoldValues solved     = calculator.solver().solve(classes[classIdx].cardSet);
+        for (quint8 hold = 0; hold < HoldSolver::kNbHolds; ++hold) {
+            QCOMPARE(solved.expectedValue[hold], enumerated.expectedValue[hold]);
+        }
+        QCOMPARE(solved.bestHold, enumerated.bestHold);
+    }
+}
+
+void TestReturnCalculator::testSolverHandPositions()
+{
+    JacksOrBetter JOB;
+    HoldSolver    solver(&JOB, 5);
+
+    // A pair of jacks amongst garbage: keep the jacks, wherever they are in the hand
+    const Hand deal(PlayingCard(PlayingCard::CLUB,    PlayingCard::FOUR ),
+                    PlayingCard(PlayingCard::SPADE,   PlayingCard::JACK ),
+                    PlayingCard(PlayingCard::HEART,   PlayingCard::NINE ),
+                    PlayingCard(PlayingCard::DIAMOND, PlayingCard::TWO  ),
+                    PlayingCard(PlayingCard::DIAMOND, PlayingCard::JACK ));
+    const HoldSolver::HoldValues byPosition = solver.solve(deal);
+    QCOMPARE(byPosition.bestHold, quint8(0x12));
+
+    // Same values as solving the card set, only the hold bits are moved around
+    const HoldSolver::HoldValues byCardIndex = solver.solve(deal.cardSet());
+    QCOMPARE(byPosition.expectedValue[0], byCardIndex.expectedValue[0]);
+    QCOMPARE(byPosition.expectedValue[HoldSolver::kNbHolds - 1], byCardIndex.expectedValue[HoldSolver::kNbHolds - 1]);
+    QCOMPARE(byPosition.expectedValue[byPosition.bestHold], byCardIndex.expectedValue[byCardIndex.bestHold]);
+}
+
+void TestReturnCalculator::testAdvisorSuitRenaming()
+{
+    JacksOrBetter JOB;
+    HoldAdvisor   advisor(&JOB);
+
+    // Four to a royal in hearts, in a scrambled order
+    const Hand hearts(PlayingCard(PlayingCard::HEART,   PlayingCard::KING ),
+                      PlayingCard(PlayingCard::CLUB,    PlayingCard::THREE),
+                      PlayingCard(PlayingCard::HEART,   PlayingCard::ACE  ),
+                      PlayingCard(PlayingCard::HEART,   PlayingCard::TEN  ),
+                      PlayingCard(PlayingCard::HEART,   PlayingCard::QUEEN));
+    const HoldAdvisor::Advice heartsAdvice = advisor.advise(hearts, 5);
+    QCOMPARE(heartsAdvice.holdMask, quint8(0x1D));
+    QCOMPARE(advisor.nbCachedHands(), 1);
+
+    // The same deal with the suits renamed and the cards moved around is answered from the cache
+    const Hand spades(PlayingCard(PlayingCard::SPADE,   PlayingCard::TEN  ),
+                      PlayingCard(PlayingCard::SPADE,   PlayingCard::ACE  ),
+                      PlayingCard(PlayingCard::DIAMOND, PlayingCard::THREE),
+                      PlayingCard(PlayingCard::SPADE,   PlayingCard::QUEEN),
+                      PlayingCard(PlayingCard::SPADE,   PlayingCard::KING ));
+    const HoldAdvisor::Advice spadesAdvice = advisor.advise(spades, 5);
+    QCOMPARE(spadesAdvice.holdMask, quint8(0x1B));
+    QCOMPARE(spadesAdvice.expectedValue, heartsAdvice.expectedValue);
+    QCOMPARE(advisor.nbCachedHands(), 1);
+
+    // The advice matches the solver, and other bets are cached apart
+    const HoldSolver             solver(&JOB, 5);
+    const HoldSolver::HoldValues spadesValues = solver.solve(spades);
+    QCOMPARE(spadesAdvice.expectedValue, spadesValues.expectedValue[spadesValues.bestHold]);
+    advisor.advise(spades, 1);
+    QCOMPARE(advisor.nbCachedHands(), 2);
+}
+
+void TestReturnCalculator::testStrategyTable()
+{
+    JacksOrBetter    JOB;
+    const HoldSolver solver(&JOB, 5);
+    const QString    fileName = QDir(QDir::tempPath()).filePath(StrategyTable::fileName(JOB, 5));
+    StrategyTable::write(fileName, solver, JOB.payTableHash());
+
+    // Every hold of the hand matches the solver (within float precision)
+    {
+        const StrategyTable table(fileName, JOB, 5);
+        const Hand deal(PlayingCard(PlayingCard::CLUB,    PlayingCard::FOUR ),
+                        PlayingCard(PlayingCard::SPADE,   PlayingCard::JACK ),
+                        PlayingCard(PlayingCard::HEART,   PlayingCard::NINE ),
+                        PlayingCard(PlayingCard::DIAMOND, PlayingCard::TWO  ),
+                        PlayingCard(PlayingCard::DIAMOND, PlayingCard::JACK ));
+        const HoldSolver::HoldValues fromTable  = table.solve(deal);
+        const HoldSolver::HoldValues fromSolver = solver.solve(deal);
+        QCOMPARE(fromTable.bestHold, fromSolver.bestHold);
+        for (quint8 hold = 0; hold < HoldSolver::kNbHolds; ++hold) {
+            QVERIFY(qAbs(fromTable.expectedValue[hold] - fromSolver.expectedValue[hold]) < 0.0001);
+        }
+    }
+
+    // The file is refused for another bet or paytable
+    BonusPoker BP;
+    QVERIFY_EXCEPTION_THROWN(StrategyTable(fileName, JOB, 1), std::runtime_error);
+    QVERIFY_EXCEPTION_THROWN(StrategyTable(fileName, BP, 5), std::runtime_error);
+    QFile::remove(fileName);
+}
+
+void TestReturnCalculator::testDrawOutcomes()
+{
+    JacksOrBetter JOB;
+    const QString fileName = QDir(QDir::tempPath()).filePath("jacksorbetter.vpdraws");
+    DrawOutcomes(&JOB).save(fileName);
+    const DrawOutcomes outcomes(fileName);
+    QFile::remove(fileName);
+    QCOMPARE(outcomes.nbRows(), 10);
+
+    // Holding a whole royal can only make the royal, and every hold draws each possible replacement exactly once
+    const Hand royal(PlayingCard(PlayingCard::SPADE, PlayingCard::ACE  ),
+                     PlayingCard(PlayingCard::SPADE, PlayingCard::KING ),
+                     PlayingCard(PlayingCard::SPADE, PlayingCard::QUEEN),
+                     PlayingCard(PlayingCard::SPADE, PlayingCard::JACK ),
+                     PlayingCard(PlayingCard::SPADE, PlayingCard::TEN  ));
+    QVector<quint32> drawCounts;
+    outcomes.countDraws(royal.cardSet(), drawCounts);
+    QCOMPARE(drawCounts[(HoldSolver::kNbHolds - 1) * outcomes.nbRows()], quint32(1));
+    for (quint8 hold = 0; hold < HoldSolver::kNbHolds; ++hold) {
+        quint32 nbDraws = 0;
+        for (int row = 0; row < outcomes.nbRows(); ++row) {
+            nbDraws += drawCounts[hold * outcomes.nbRows() + row];
+        }
+        const quint8 nbToDraw = Hand::kCardsPerHand - static_cast<quint8>(qPopulationCount(hold));
+        QCOMPARE(nbDraws, HandCombinatorics::binomial(PlayingCard::kNbCards - Hand::kCardsPerHand, nbToDraw));
+    }
+
+    // Another paytable with the same rows is valued from the loaded counts: 8/5 Jacks or Better returns 97.2984%
+    EightFiveJacks eightFive;
+    QVERIFY(qAbs(ReturnCalculator(outcomes, eightFive, 5).computeReturn() - 0.972984) < 0.000001);
+
+    // Bonus Poker has other rows
+    BonusPoker BP;
+    QVERIFY_EXCEPTION_THROWN(ReturnCalculator(outcomes, BP, 5), std::runtime_error);
+
+    // A file giving a hand a row that is not in the paytable is refused
+    outcomes.save(fileName);
+    qint64 rowsPos = 0;
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QDataStream      stream(&file);
+        quint32          header     = 0;
+        quint32          nbHandRows = 0;
+        QVector<QString> rowNames;
+        stream.setVersion(QDataStream::Qt_5_0);
+        stream >> header >> header >> rowNames >> nbHandRows;
+        rowsPos = file.pos();
+    }
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.seek(rowsPos));
+        QVERIFY(file.putChar(static_cast<char>(outcomes.nbRows())));
+    }
+    QVERIFY_EXCEPTION_THROWN(DrawOutcomes(fileName).nbRows(), std::runtime_error);
+    QFile::remove(fileName);
+}
+
+void TestReturnCalculator::testPaytableOptimizer()
+{
+    JacksOrBetter      JOB;
+    const DrawOutcomes outcomes(&JOB);
+    PaytableOptimizer  optimizer(outcomes, JOB, 5);
+
+    // The well-known variance of 9/6 Jacks or Better is 19.51
+    QVERIFY(qAbs(optimizer.computeVariance(optimizer.baseCredits()) - 19.51) < 0.01);
+
+    // Only searching the full house and the flush, the closest paytable to 97.2984% is 8/5
+    for (int row = 0; row < optimizer.rowNames().size(); ++row) {
+        optimizer.setRowFixed(row, row != 3 && row != 4);
+    }
+    const QVector<PaytableOptimizer::Candidate> candidates = optimizer.search(0.972984, 2);
+    QCOMPARE(candidates.size(), 2);
+    QCOMPARE(candidates[0].creditsByRow[3], quint32(40));
+    QCOMPARE(candidates[0].creditsByRow[4], quint32(25));
+    QVERIFY(qAbs(candidates[0].gameReturn - 0.972984) < 0.000001);
+    QVERIFY(candidates[0].variance > 0.0);
+    QVERIFY(qAbs(candidates[1].gameReturn - 0.972984) >= qAbs(candidates[0].gameReturn - 0.972984));
+    QCOMPARE(candidates[0].creditsByRow[0], quint32(4000));
+}
+
+void TestReturnCalculator::testTurboSimulator()
+{
+    JacksOrBetter JOB;
+
+    // Holding every dealt card scores the deals themselves: 337,920 of the 2,598,960 deals hit the Jacks or Better row
+    TurboSimulator                dealSimulator(&JOB, 1);
+    const FixedHoldStrategy       holdAll(Hand::kAllHeld);
+    const TurboSimulator::Results deals = dealSimulator.run(200000, holdAll, 1, 4);
+    QCOMPARE(deals.nbGames, Q_UINT64_C(200000));
+    QCOMPARE(deals.nbHands, Q_UINT64_C(200000));
+    QCOMPARE(deals.creditsBet, Q_UINT64_C(200000));
+    quint64 nbHands = 0;
+    for (quint64 rowHands : deals.handsByRow) {
+        nbHands += rowHands;
+    }
+    QCOMPARE(nbHands, deals.nbHands);
+    QVERIFY(qAbs(deals.handsByRow[8] / 200000.0 - 337920.0 / 2598960.0) < 0.005);
+
+    // A seed always plays the same games, whatever the number of threads
+    TurboSimulator                multiSimulator(&JOB, 5, 3);
+    const HoldSolver              solver(&JOB, 5);
+    const OptimalHoldStrategy     optimal(solver);
+    const TurboSimulator::Results oneThread   = multiSimulator.run(10000, optimal, 42, 1);
+    const TurboSimulator::Results fourThreads = multiSimulator.run(10000, optimal, 42, 4);
+    QCOMPARE(oneThread.nbHands, Q_UINT64_C(30000));
+    QCOMPARE(oneThread.creditsBet, Q_UINT64_C(150000));
+    QCOMPARE(oneThread.creditsWon, fourThreads.creditsWon);
+    QCOMPARE(oneThread.handsByRow, fourThreads.handsByRow);
+    QVERIFY(oneThread.handsByRow != multiSimulator.run(10000, optimal, 43, 1).handsByRow);
+
+    // Optimal play returns about 99.54% (the standard deviation of the return of 30,000 hands is about 2.5%)
+    QVERIFY(qAbs(oneThread.gameReturn() - 0.995439) < 0.1);
+}
+
+void TestReturnCalculator::testDrawSampler()
+{
+    // Binomials have the mean and variance of the distribution, whether sampled by inversion (mean below 10) or by
+    // rejection, and the same whichever of success and failure is the less likely
+    Xoshiro256Engine engine(7);
+    const int        nbSamples = 20000;
+    const QVector<QPair<quint32, double>> binomials = {{50, 0.05}, {10000, 0.3}, {10000, 0.9}, {1000000, 0.0001}};
+    for (const QPair<quint32, double> &binomial : binomials) {
+        double sum        = 0.0;
+        double sumSquares = 0.0;
+        for (int sample = 0; sample < nbSamples; ++sample) {
+            const quint32 successes = DrawSampler::sampleBinomial(engine, binomial.first, binomial.second);
+            QVERIFY(successes <= binomial.first);
+            sum        += successes;
+            sumSquares += static_cast<double>(successes) * successes;
+        }
+        const double mean     = binomial.first * binomial.second;
+        const double variance = mean * (1.0 - binomial.second);
+        const double average  = sum / nbSamples;
+        QVERIFY(qAbs(average - mean) < 5.0 * std::sqrt(variance / nbSamples));
+        QVERIFY(qAbs((sumSquares / nbSamples - average * average) / variance - 1.0) < 0.05);
+    }
+    QCOMPARE(DrawSampler::sampleBinomial(engine, 100, 0.0), quint32(0));
+    QCOMPARE(DrawSampler::sampleBinomial(engine, 100, 1.0), quint32(100));
+
+    // Holding a set of cards, the hands drawn end on the rows of all the 5-card hands containing it
+    JacksOrBetter          JOB;
+    DrawOutcomes           outcomes(&JOB);
+    const DrawSampler      sampler(outcomes);
+    const Hand             pairOfJacks(PlayingCard(PlayingCard::HEART,   PlayingCard::JACK ),
+                                       PlayingCard(PlayingCard::SPADE,   PlayingCard::JACK ),
+                                       PlayingCard(PlayingCard::CLUB,    PlayingCard::TWO  ),
+                                       PlayingCard(PlayingCard::DIAMOND, PlayingCard::SEVEN),
+                                       PlayingCard(PlayingCard::HEART,   PlayingCard::NINE ));
+    const quint64          heldJacks = pairOfJacks.cardAt(0).cardBit() | pairOfJacks.cardAt(1).cardBit();
+    const QVector<quint32> jacksDraws = sampler.rowDistribution(heldJacks);
+    quint32 nbDraws = 0;
+    for (quint32 rowDraws : jacksDraws) {
+        nbDraws += rowDraws;
+    }
+    QCOMPARE(nbDraws, HandCombinatorics::binomial(50, 3));
+    QCOMPARE(jacksDraws[0], quint32(0));
+    QVector<quint32> dealsByRow(outcomes.nbRows(), 0);
+    for (quint8 row : outcomes.rowByHand()) {
+        ++dealsByRow[row];
+    }
+    QCOMPARE(sampler.rowDistribution(0), dealsByRow);
+
+    // Holding the whole hand always ends on its row, and the rows sampled add up to the hands drawn
+    const QVector<quint32> heldHand = sampler.sampleRows(pairOfJacks.cardSet(), 10000, engine);
+    QCOMPARE(heldHand[JOB.evaluateHand(pairOfJacks, 1).payoutIdx], quint32(10000));
+    const QVector<quint32> jacksRows = sampler.sampleRows(heldJacks, 1000000, engine);
+    quint32 nbSampled = 0;
+    for (int row = 0; row < jacksRows.size(); ++row) {
+        nbSampled += jacksRows[row];
+        QVERIFY(jacksDraws[row] != 0 || jacksRows[row] == 0);
+    }
+    QCOMPARE(nbSampled, quint32(1000000));
+}
+
+void TestReturnCalculator::testTurboSimulatorMatchesOrchestrator()
+{
+    // 10-hand games whose holds depend on the deal, played by the orchestrator...
+    const SplitPairStrategy strategy;
+    const int               nbGames = 20000;
+    JacksOrBetter           JOB;
+    Account                 playerAcct;
+    GameOrchestrator        orchestrator(&JOB, 10, playerAcct, 0);
+    playerAcct.add(10 * nbGames);
+    orchestrator.setGameSeed(11);
+    QVector<quint64> orchestratorRows(JOB.nbPayTableRows(), 0);
+    for (int game = 0; game < nbGames; ++game) {
+        orchestrator.dealDraw();
+        const quint8 holdMask = strategy.chooseHold(orchestrator.retrieveHand(0));
+        for (quint8 cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+            orchestrator.hold(cardIdx, (holdMask & (1 << cardIdx)) != 0);
+        }
+        orchestrator.dealDraw();
+        for (qint32 handIdx = 0; handIdx < 10; ++handIdx) {
+            ++orchestratorRows[JOB.evaluateHand(orchestrator.retrieveHand(handIdx), 1).payoutIdx];
+        }
+    }
+
+    // ... and by the simulator hit the rows of the paytable as often
+    TurboSimulator                simulator(&JOB, 1, 10);
+    const TurboSimulator::Results simulated = simulator.run(nbGames, strategy, 11);
+    // (below the value a chi-square statistic only exceeds with a probability of 0.001, by Wilson-Hilferty)
+    int          degrees   = 0;
+    const double statistic = chiSquareHomogeneity(orchestratorRows, simulated.handsByRow, degrees);
+    const double spread    = 2.0 / (9.0 * degrees);
+    QVERIFY(statistic < degrees * std::pow(1.0 - spread + 3.09 * std::sqrt(spread), 3.0));
+}
+
+void TestReturnCalculator::testJacksOrBetterReturn()
+{
+    // The well-known return of full-pay (9/6) Jacks or Better at maximum bet is 99.5439%
+    JacksOrBetter    JOB;
+    ReturnCalculator calculator(&JOB, 5);
+    QVERIFY(qAbs(calculator.computeReturn() - 0.995439) < 0.000001);
+}
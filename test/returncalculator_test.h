@@ -0,0 +1,52 @@
+/*
+ * This file is part of VidPokerTerm. Copyright (c) 2020 Daniel Brook
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RETURNCALCULATOR_TEST_H
+#define RETURNCALCULATOR_TEST_H
+
+#include <QObject>
+#include <QtTest/QtTest>
+
+/**
+ * @brief TestReturnCalculator validates the combinatorics helpers (handcombinatorics.h/cpp), the hold values computed
+ *        by the return calculator (returncalculator.h/cpp) on hands whose values can be worked out by hand, the fast
+ *        hold solver (holdsolver.h/cpp) against the draw-by-draw enumeration, the advice cache shared by suit renamings
+ *        of a deal (holdadvisor.h/cpp), the strategy files (strategytable.h/cpp), the paytable-independent draw counts
+ *        (drawoutcomes.h/cpp), the paytable search (paytableoptimizer.h/cpp), the headless simulator
+ *        (turbosimulator.h/cpp), the sampled draws (drawsampler.h/cpp), and the well-known returns of 9/6 and 8/5
+ *        Jacks or Better
+ */
+class TestReturnCalculator : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testColexIndex();
+    void testCanonicalHands();
+    void testFourToARoyal();
+    void testSolverMatchesEnumeration();
+    void testSolverHandPositions();
+    void testAdvisorSuitRenaming();
+    void testStrategyTable();
+    void testDrawOutcomes();
+    void testPaytableOptimizer();
+    void testTurboSimulator();
+    void testTurboSimulatorMatchesOrchestrator();
+    void testDrawSampler();
+    void testJacksOrBetterReturn();
+};
+
+#endif // RETURNCALCULATOR_TEST_H
@@ -36,10 +36,14 @@ LIBS *= -L$$DESTDIR -lpokerbe
 PRE_TARGETDEPS += $$OUT_PWD/../bin/libpokerbe.a
 
 SOURCES += \
+    handevaluator_test.cpp \
     jacksorbetter_orctest.cpp \
     pokerhand_test.cpp \
+    returncalculator_test.cpp \
     test_main.cpp
 
 HEADERS += \
+    handevaluator_test.h \
     jacksorbetter_orctest.h \
-    pokerhand_test.h
+    pokerhand_test.h \
+    returncalculator_test.h
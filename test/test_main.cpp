@@ -16,7 +16,9 @@
  */
 
 #include "pokerhand_test.h"
+#include "handevaluator_test.h"
 #include "jacksorbetter_orctest.h"
+#include "returncalculator_test.h"
 
 /**
  * @brief main wraps together all tests into a single binary
@@ -29,9 +31,17 @@ int main(int argc, char *argv[])
     TestHands th;
     status |= QTest::qExec(&th, argc, argv);
 
+    // Table-Driven Hand Evaluator Tests
+    TestHandEvaluator the;
+    status |= QTest::qExec(&the, argc, argv);
+
     // Jacks-or-Better Game Orchestrator Tests
     JacksOrBetter_OrcTest job_oc;
     status |= QTest::qExec(&job_oc, argc, argv);
 
+    // Return (RTP) Calculator Tests
+    TestReturnCalculator trc;
+    status |= QTest::qExec(&trc, argc, argv);
+
     return status;
 }
@@ -152,7 +152,7 @@ void GameAccountWindow::changeNumberOfHands(int increaseDecrease)
         switch (currentHandCount) {
         case 1:
 //            nextHandCount = 100;
-            nextHandCount = 25;
+            nextHandCount = 10000;
             break;
         case 5:
             nextHandCount = 3;
@@ -166,6 +166,12 @@ void GameAccountWindow::changeNumberOfHands(int increaseDecrease)
 //        case 100:
 //            nextHandCount = 25;
 //            break;
+        case 1000:
+            nextHandCount = 25;
+            break;
+        case 10000:
+            nextHandCount = 1000;
+            break;
         default:
             nextHandCount = 1;
         }
@@ -186,6 +192,13 @@ void GameAccountWindow::changeNumberOfHands(int increaseDecrease)
 //        case 25:
 //            nextHandCount = 100;
 //            break;
+        case 25:
+            // Ultra games only show a sample of the hands (see GameOrchestrator::setUltraMode)
+            nextHandCount = 1000;
+            break;
+        case 1000:
+            nextHandCount = 10000;
+            break;
         default:
             nextHandCount = 1;
         }
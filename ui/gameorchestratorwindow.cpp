@@ -24,6 +24,9 @@
 // Individual games supported
 #include "jacksorbetter.h"
 
+#include <QCoreApplication>
+#include <QLabel>
+
 GameOrchestratorWindow::GameOrchestratorWindow(Account   &playerAccount,
                                                PokerGame *gameLogic,
                                                int        handsToPlay,
@@ -32,13 +35,22 @@ GameOrchestratorWindow::GameOrchestratorWindow(Account   &playerAccount,
       _playerCredits(playerAccount),
       _gameLogic(gameLogic),
       _handsToPlay(handsToPlay),
+      _primaryHand(nullptr),
+      _shownHoldMask(0),
+      _handsSummary(nullptr),
+      _gameInProgress(false),
+      _revealing(false),
       ui(new Ui::GameOrchestratorWindow)
 {
     // Setup the UI
     ui->setupUi(this);
 
-    // Now bring in the game logic
+    // Now bring in the game logic (optimal holds come from the strategy files next to the program, if any)
     _gameOrc = new GameOrchestrator(_gameLogic, _handsToPlay, _playerCredits, 0);
+    _gameOrc->setStrategyDirectory(QCoreApplication::applicationDirPath());
+
+    // The cards and results of a deal or draw come as one snapshot of all the hands per render step
+    _gameOrc->setSnapshotSignals(true);
 
     // Fill in the number of credits the first time
     ui->creditsAmount->setText(QString::number(_playerCredits.balance()));
@@ -68,14 +80,20 @@ GameOrchestratorWindow::GameOrchestratorWindow(Account   &playerAccount,
     connect(ui->drawDealButton, &QPushButton::clicked, this, &GameOrchestratorWindow::syncDealDraw);
     connect(this, &GameOrchestratorWindow::readyForDealDraw, _gameOrc, &GameOrchestrator::dealDraw);
 
-    // While the orchestrator is working, it should not be burdened with deal-draw requests
-    connect(_gameOrc, &GameOrchestrator::operating, this, &GameOrchestratorWindow::disableDealDraw);
+    // While the cards are revealed the button only skips the animation, it never asks for a deal or a draw
+    connect(this, &GameOrchestratorWindow::skipRequested, _gameOrc, &GameOrchestrator::skipAnimation);
+    connect(_gameOrc, &GameOrchestrator::operating, this, &GameOrchestratorWindow::dealDrawToSkip);
+
+    // A deal refused for lack of credits is the only answer without a reveal, the button is usable again at once
+    connect(_gameOrc, &GameOrchestrator::insufficientFunds, this, [=]() {
+        ui->drawDealButton->setDisabled(false);
+    });
 
     // The text of the button should say 'deal' when a game is not in progress, but 'draw' when it is
     connect(_gameOrc, &GameOrchestrator::gameInProgress, this, &GameOrchestratorWindow::dealToDraw);
 
-    // Connect the winnings display widget to the orchestrator
-    connect(_gameOrc, &GameOrchestrator::gameWinnings, this, &GameOrchestratorWindow::currentWinnings);
+    // Connect the hands, their winnings and the total won to the snapshots of the orchestrator
+    connect(_gameOrc, &GameOrchestrator::gameSnapshot, this, &GameOrchestratorWindow::applySnapshot);
 
     // Connect the account balance to the display
     connect(&_playerCredits, &Account::balanceChanged, this, &GameOrchestratorWindow::currentBalance);
@@ -85,12 +103,7 @@ GameOrchestratorWindow::GameOrchestratorWindow(Account   &playerAccount,
      */
     HandWidget *PrimaryHand = new HandWidget(false, QSize(125, 175), "32", "", this);
     ui->primaryHand->layout()->addWidget(PrimaryHand);
-
-    // Connect [primary] hand widgets to the game orchestrator to show results, winnings
-    connect(_gameOrc, &GameOrchestrator::primaryHandUpdated, PrimaryHand, &HandWidget::winningTextAndAmount);
-
-    // Connect [primary] hand card reveals to the widget as they're turned from the orchestrator
-    connect(_gameOrc, &GameOrchestrator::primaryCardRevealed, PrimaryHand, &HandWidget::revealCard);
+    _primaryHand = PrimaryHand;
 
     // Card holding (for the primary hand) - set to disabled to start
     PrimaryHand->enableHolds(false);
@@ -187,10 +200,31 @@ GameOrchestratorWindow::GameOrchestratorWindow(Account   &playerAccount,
                 column = 9;
             }
         }
+    } else if (_handsToPlay > 100) {
+        // Ultra games: only a sample of the secondary hands is dealt out, the summary of all the hands sits next to it
+        _gameOrc->setUltraMode(true);
+        int column = 2;
+        int row    = 0;
+        for (quint32 extraHands = 0; extraHands < GameOrchestrator::kUltraSampleHands; ++extraHands) {
+            HandWidget *ExtraHand = new HandWidget(true, QSize(60, 80), "18", "", this);
+            secondaryHandsLayout->addWidget(ExtraHand, row, column);
+            _addedHands.push_front(ExtraHand);
+
+            // Determine the row and column of the next hand to render
+            column = column - 1;
+            if (column == -1) {
+                ++row;
+                column = 2;
+            }
+        }
+        _handsSummary = new QLabel(this);
+        _handsSummary->setAlignment(Qt::AlignLeft | Qt::AlignTop);
+        secondaryHandsLayout->addWidget(_handsSummary, 0, 3, row, 1);
+        connect(_gameOrc, &GameOrchestrator::handsSummary, this, &GameOrchestratorWindow::showHandsSummary);
     }
 
-    connect(_gameOrc, &GameOrchestrator::secondaryCardRevealed, this, &GameOrchestratorWindow::updateSecondaryHandCard);
-    connect(_gameOrc, &GameOrchestrator::secondaryHandUpdated, this, &GameOrchestratorWindow::secondaryWinTextAndAmt);
+    // Held cards are shown (or hidden) on the secondary hands as the player holds them
+    connect(_gameOrc, &GameOrchestrator::holdMaskChanged, this, &GameOrchestratorWindow::showSecondaryHolds);
 
     /*
      * Render Speed Control
@@ -201,6 +235,13 @@ GameOrchestratorWindow::GameOrchestratorWindow(Account   &playerAccount,
     // Render the speed setting on the speed button
     connect(_gameOrc, &GameOrchestrator::renderSpeed, this, &GameOrchestratorWindow::updateSpeedChar);
 
+    /*
+     * Hold assistance: show (or apply) the optimal hold of each deal once it has been computed in the background
+     */
+    connect(ui->assistButton, &QPushButton::clicked, _gameOrc, &GameOrchestrator::holdAssistCycle);
+    connect(_gameOrc, &GameOrchestrator::holdAssistChanged, this, &GameOrchestratorWindow::updateAssistText);
+    connect(_gameOrc, &GameOrchestrator::optimalHoldFound, this, &GameOrchestratorWindow::showOptimalHold);
+
     /*
      * Offload the game processor to its own thread (per https://wiki.qt.io/QThreads_general_usage)
      * Using a separate thread seems to necessitate registering the type?
@@ -267,6 +308,8 @@ void GameOrchestratorWindow::showPayTableAndBet()
 
 void GameOrchestratorWindow::dealToDraw(bool showDraw)
 {
+    _gameInProgress = showDraw;
+
     // When the game is in progress, ONLY let the draw button be pressed
     if (showDraw) {
         ui->drawDealButton->setText("Draw");
@@ -287,18 +330,34 @@ void GameOrchestratorWindow::dealToDraw(bool showDraw)
     }
 }
 
-void GameOrchestratorWindow::disableDealDraw(bool dealDrawDisabled)
+void GameOrchestratorWindow::dealDrawToSkip(bool showSkip)
 {
-    // Do not let the deal/draw button get pressed again while the orchestrator is working
-    ui->drawDealButton->setDisabled(dealDrawDisabled);
-
-    // Do not let the speed adjuster get pressed either
-    ui->speedButton->setDisabled(dealDrawDisabled);
+    // The deal/draw button stays usable while the cards are being revealed: pressing it again skips the animation.
+    // The speed adjuster stays usable too, the new speed applies from the next card turned.
+    _revealing = showSkip;
+    ui->drawDealButton->setDisabled(false);
+    if (showSkip) {
+        ui->drawDealButton->setText("Skip");
+    } else {
+        ui->drawDealButton->setText(_gameInProgress ? "Draw" : "Deal");
+    }
+    ui->drawDealButton->setShortcut(QKeySequence("/"));
 }
 
 void GameOrchestratorWindow::syncDealDraw()
 {
-    if (!_gameOrc->isGameInProgress()) {
+    // Until the orchestrator answers (a reveal starting or ending, or a lack of credits), another press would be queued
+    // as a request of its own, on a state the window does not know yet
+    ui->drawDealButton->setDisabled(true);
+
+    // A skip arriving once the reveal is over is ignored by the orchestrator, where a deal-draw request would start
+    // another game
+    if (_revealing) {
+        emit skipRequested();
+        return;
+    }
+
+    if (!_gameInProgress) {
         emit resetCardDisplay();
     }
 
@@ -321,6 +380,12 @@ void GameOrchestratorWindow::updateSpeedChar(const QString &speedStr)
     ui->speedButton->setShortcut(QKeySequence("M"));
 }
 
+void GameOrchestratorWindow::updateAssistText(const QString &assistStr)
+{
+    ui->assistButton->setText("Assist " + assistStr);
+    ui->assistButton->setShortcut(QKeySequence("B"));
+}
+
 void GameOrchestratorWindow::holdCard1(bool cardHeld)
 {
     _gameOrc->hold(0, cardHeld);
@@ -378,9 +443,14 @@ void GameOrchestratorWindow::updateSecondaryHandCard(int secoHandPos, int cardPo
     }
 }
 
-void GameOrchestratorWindow::secondaryWinTextAndAmt(int secoHandPos, const QString &handString, quint32 winning)
+void GameOrchestratorWindow::primaryWinTextAndAmt(quint8 payoutIdx, quint32 winning)
 {
-    _addedHands[secoHandPos]->winningTextAndAmount(handString, winning);
+    _primaryHand->winningTextAndAmount(_gameLogic->handString(payoutIdx), winning);
+}
+
+void GameOrchestratorWindow::secondaryWinTextAndAmt(int secoHandPos, quint8 payoutIdx, quint32 winning)
+{
+    _addedHands[secoHandPos]->winningTextAndAmount(_gameLogic->handString(payoutIdx), winning);
 }
 
 void GameOrchestratorWindow::flipAllHands()
@@ -388,4 +458,88 @@ void GameOrchestratorWindow::flipAllHands()
     for (HandWidget *secoHand : _addedHands) {
         secoHand->resetAll();
     }
+    _shownSnapshot.clear();
+    _shownHoldMask = 0;
+    if (_handsSummary) {
+        _handsSummary->clear();
+    }
+}
+
+void GameOrchestratorWindow::showOptimalHold(quint8 holdMask, double expectedValue, bool holdApplied)
+{
+    Q_UNUSED(expectedValue);
+    _primaryHand->showHoldHint(holdMask, holdApplied);
+}
+
+void GameOrchestratorWindow::showSecondaryHolds(quint8 holdMask)
+{
+    // The held cards are those of the primary hand dealt (the snapshot of the deal has them all)
+    const quint8 changedHolds = static_cast<quint8>(holdMask ^ _shownHoldMask);
+    if (_shownSnapshot.isNull() || _shownSnapshot->hands.isEmpty() || changedHolds == 0) {
+        return;
+    }
+
+    ui->centralwidget->setUpdatesEnabled(false);
+    for (int cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+        if (changedHolds & (1 << cardIdx)) {
+            const PlayingCard card = _shownSnapshot->hands[0].cardAt(cardIdx);
+            for (int secoHandPos = 0; secoHandPos < _addedHands.size(); ++secoHandPos) {
+                updateSecondaryHandCard(secoHandPos, cardIdx, card, (holdMask & (1 << cardIdx)) != 0);
+            }
+        }
+    }
+    ui->centralwidget->setUpdatesEnabled(true);
+    _shownHoldMask = holdMask;
+}
+
+void GameOrchestratorWindow::showHandsSummary(QVector<quint32> handsByRow, quint32 totalWinnings)
+{
+    QStringList summaryLines;
+    for (int row = 0; row < handsByRow.size(); ++row) {
+        const QString &handName = _gameLogic->handString(static_cast<quint8>(row));
+        summaryLines << QString("%1: %2").arg(handName.isEmpty() ? QString("No win") : handName)
+                                         .arg(handsByRow[row]);
+    }
+    summaryLines << QString("Total won: %1").arg(totalWinnings);
+    _handsSummary->setText(summaryLines.join("\n"));
+}
+
+void GameOrchestratorWindow::applySnapshot(QSharedPointer<const GameSnapshot> snapshot)
+{
+    // The cards and results already shown by an earlier snapshot of the same deal (or draw) are left as they are
+    const bool sameStage = !_shownSnapshot.isNull() && _shownSnapshot->drawn == snapshot->drawn;
+
+    // Nothing is repainted until the whole snapshot is applied
+    ui->centralwidget->setUpdatesEnabled(false);
+
+    for (int handIdx = 0; handIdx < snapshot->hands.size(); ++handIdx) {
+        const quint8 shownCards  = sameStage ? _shownSnapshot->faceUpCards[handIdx] : 0;
+        const quint8 cardsToTurn = static_cast<quint8>(snapshot->faceUpCards[handIdx] & ~shownCards);
+        for (int cardIdx = 0; cardIdx < Hand::kCardsPerHand; ++cardIdx) {
+            if (cardsToTurn & (1 << cardIdx)) {
+                const PlayingCard &card = snapshot->hands[handIdx].cardAt(cardIdx);
+                if (handIdx == 0) {
+                    _primaryHand->revealCard(cardIdx, card);
+                } else {
+                    updateSecondaryHandCard(handIdx - 1, cardIdx, card, true);
+                }
+            }
+        }
+    }
+
+    for (int handIdx = sameStage ? _shownSnapshot->results.size() : 0; handIdx < snapshot->results.size(); ++handIdx) {
+        const PokerGame::HandResult &result = snapshot->results[handIdx];
+        if (handIdx == 0) {
+            primaryWinTextAndAmt(result.payoutIdx, result.creditsWon);
+        } else {
+            secondaryWinTextAndAmt(handIdx - 1, result.payoutIdx, result.creditsWon);
+        }
+    }
+
+    if (snapshot->drawn) {
+        currentWinnings(snapshot->totalWinnings);
+    }
+
+    ui->centralwidget->setUpdatesEnabled(true);
+    _shownSnapshot = snapshot;
 }
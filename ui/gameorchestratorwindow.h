@@ -32,6 +32,7 @@ class GameOrchestratorWindow;
 }
 
 class HandWidget;
+class QLabel;
 
 /**
  * @brief The GameOrchestratorWindow provides a graphical interface to a generic PokerGame logic via an orchestrator
@@ -45,6 +46,9 @@ class HandWidget;
  *        100 simultaneous hands. The way these "secondary hands" are drawn to the screen depends on how many are
  *        played. The increment is not uniform either, but stepped: 1 -> 3 -> 5 -> 10 -> 25 ---> 100 (!)
  *
+ *        Ultra games (above 100 hands, e.g. 1,000 or 10,000) only deal out a sample of the secondary hands on screen
+ *        (see GameOrchestrator::setUltraMode), all the hands being summed up by paytable row next to them.
+ *
  *        Be advised that screen constraints get a little troublesome above 10 hands, especially on 1080p monitors.
  *
  *        In the constructor, the font and pixel sizes can be updated to work with your screen situation (since this
@@ -74,8 +78,8 @@ public slots:
     // set showDraw to true so the button for deal/draw only says "Draw", otherwise it is "Deal"
     void dealToDraw(bool showDraw);
 
-    // Disables the deal-draw button so it cannot be operated
-    void disableDealDraw(bool dealDrawDisabled);
+    // set showSkip to true so the button for deal/draw says "Skip" while the cards are revealed
+    void dealDrawToSkip(bool showSkip);
 
     // Resets the cards BEFORE calling the dealDraw of the orchestrator (prevents exceptions/collisions between threads)
     void syncDealDraw();
@@ -99,12 +103,30 @@ public slots:
     // Update Secondary Hand at secoHandPos
     void updateSecondaryHandCard(int secoHandPos, int cardPos, PlayingCard cardToShow, bool show);
 
+    // Show the win of the primary hand (looking up the name of the paytable row)
+    void primaryWinTextAndAmt(quint8 payoutIdx, quint32 winning);
+
     // Show the win of a secondary hand at secoHandPos
-    void secondaryWinTextAndAmt(int secoHandPos, const QString &handString, quint32 winning);
+    void secondaryWinTextAndAmt(int secoHandPos, quint8 payoutIdx, quint32 winning);
 
     // Flips over all cards of all hands
     void flipAllHands();
 
+    // Sets the hold assistance level on the assist button
+    void updateAssistText(const QString &assistStr);
+
+    // Highlight (or check, if the orchestrator held them) the cards of the optimal hold on the primary hand
+    void showOptimalHold(quint8 holdMask, double expectedValue, bool holdApplied);
+
+    // Show (or hide) the cards whose hold changed on every secondary hand, in a single repaint
+    void showSecondaryHolds(quint8 holdMask);
+
+    // Show how many of the hands of an ultra game ended on each paytable row, and what they won together
+    void showHandsSummary(QVector<quint32> handsByRow, quint32 totalWinnings);
+
+    // Apply what changed in the hands since the last snapshot (cards turned, results, total won) in a single repaint
+    void applySnapshot(QSharedPointer<const GameSnapshot> snapshot);
+
 signals:
     // Should be emitted before calling the dealDraw to give the UI time to catch up before the orchestrator delivers
     // any new cards
@@ -113,13 +135,22 @@ signals:
     // Emitted when the window is ready for the orchestrator to deliver cards
     void readyForDealDraw();
 
+    // Emitted when the deal/draw button is pressed while the cards are being revealed
+    void skipRequested();
+
 private:
     Account              &_playerCredits;
     GameOrchestrator     *_gameOrc;
     PokerGame            *_gameLogic;
     int                   _handsToPlay;
+    HandWidget           *_primaryHand;
     QVector<HandWidget*>  _addedHands;
     QThread              *_gameEventProcessor;
+    QSharedPointer<const GameSnapshot> _shownSnapshot;
+    quint8                _shownHoldMask;
+    QLabel               *_handsSummary;
+    bool                  _gameInProgress;  // Last state sent by gameInProgress (the orchestrator runs in its thread)
+    bool                  _revealing;       // Last state sent by operating: cards are being revealed
     Ui::GameOrchestratorWindow *ui;
 };
 
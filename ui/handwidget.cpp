@@ -41,6 +41,11 @@ HandWidget::HandWidget(bool           extraHand,
             "background-color: qlineargradient(spread:pad, x1:0, y1:0, x2:1, y2:1, stop:0 rgba(185, 185, 185, 255),"
             "stop:1 rgba(255, 255, 255, 255));font-size:" + _fontSize + "pt;";
 
+    // Hold buttons of the optimal hold get a dashed outline until they are held
+    _holdButtonStyleSheet = ui->holdBtnCard1->styleSheet();
+    _holdHintStyleSheet   = _holdButtonStyleSheet +
+            "QPushButton:enabled:!checked {border-style: dashed; border-color: lime;}";
+
     if (!_winFontSize.isEmpty()) {
         ui->resultLabel->setStyleSheet("font-size:" + _winFontSize + "pt;");
     }
@@ -228,6 +233,7 @@ void HandWidget::resetAll()
         ui->holdBtnCard3->setChecked(false);
         ui->holdBtnCard4->setChecked(false);
         ui->holdBtnCard5->setChecked(false);
+        showHoldHint(0, false);
     }
 
     // Flip cards back
@@ -262,3 +268,18 @@ void HandWidget::enableHolds(bool enableCheckBoxes)
         ui->holdBtnCard5->setDisabled(false);
     }
 }
+
+void HandWidget::showHoldHint(quint8 holdMask, bool checkHolds)
+{
+    QPushButton *holdButtons[] = {ui->holdBtnCard1, ui->holdBtnCard2, ui->holdBtnCard3, ui->holdBtnCard4,
+                                  ui->holdBtnCard5};
+    for (int cardIdx = 0; cardIdx < 5; ++cardIdx) {
+        const bool inHold = (holdMask & (1 << cardIdx)) != 0;
+        if (checkHolds) {
+            // The orchestrator already holds the cards, so toggling the buttons does not change anything there
+            holdButtons[cardIdx]->setChecked(inHold);
+        } else {
+            holdButtons[cardIdx]->setStyleSheet(inHold ? _holdHintStyleSheet : _holdButtonStyleSheet);
+        }
+    }
+}
@@ -63,6 +63,9 @@ public slots:
     // Set the checkboxes so they may not be clicked when not in an active game
     void enableHolds(bool enableCheckBoxes);
 
+    // Outline the hold buttons of the optimal hold (bit i for card i), or check them if checkHolds is true
+    void showHoldHint(quint8 holdMask, bool checkHolds);
+
 signals:
     void card1Hold(bool cardIsHeld);
     void card2Hold(bool cardIsHeld);
@@ -77,6 +80,8 @@ private:
     QString _winFontSize;
     QString _cardFrontStyleSheet;
     QString _cardBackStyleSheet;
+    QString _holdButtonStyleSheet;
+    QString _holdHintStyleSheet;
 
     // Actual Qt widgets
     Ui::HandWidget *ui;
@@ -25,6 +25,9 @@ TEMPLATE = subdirs
 #lcdui.depends = poker lcdui lcdinterface
 
 # Uncomment the lines below to build everything
-SUBDIRS  = poker ui test lcdinterface lcdspi lcdui
+SUBDIRS  = poker ui test lcdinterface lcdspi lcdui rtp
 lcdui.depends = poker lcdui lcdinterface
 ui.depends = poker
+
+# The paytable analysis tool (rtp) only needs the core library, add it to any of the above
+rtp.depends = poker